@@ -0,0 +1,71 @@
+#!/bin/bash
+set -e
+
+# ================================
+# Paths
+# ================================
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BENCH_DIR="$SCRIPT_DIR/bin/bench"
+CORE_DIR="$SCRIPT_DIR/warpunk.core"
+BENCH_SRC_DIR="$SCRIPT_DIR/warpunk.bench"
+
+mkdir -p "$BENCH_DIR"
+mkdir -p "$BENCH_DIR/warpunk.core"
+mkdir -p "$BENCH_DIR/warpunk.bench"
+
+# ================================
+# Compiler and flags
+# ================================
+# Benchmarks are only meaningful with optimizations, debug info is kept for profilers.
+CXX=clang++
+CXXFLAGS="-std=c++17 -g -O2 -Wall -Wextra -fPIC -DNDEBUG"
+INCLUDES="-I$SCRIPT_DIR -I$CORE_DIR"
+LIBS="-lvulkan -ldl -lX11 -lX11-xcb -lxcb -lpthread"
+
+# ================================
+# Build warpunk.core (shared lib)
+# ================================
+echo
+echo "========================================="
+echo "Building warpunk.core (Shared Library)"
+echo "========================================="
+
+CORE_OBJS=""
+for src in $(find "$CORE_DIR" -name "*.cpp"); do
+    obj="$BENCH_DIR/warpunk.core/$(basename "$src" .cpp).o"
+    echo "Compiling $src"
+    $CXX $CXXFLAGS -DWARPUNK_EXPORT=1 $INCLUDES -c "$src" -o "$obj"
+    CORE_OBJS="$CORE_OBJS $obj"
+done
+
+$CXX -shared -o "$BENCH_DIR/libwarpunk.core.so" $CORE_OBJS $LIBS
+
+# ================================
+# Build warpunk_bench (executable)
+# ================================
+echo
+echo "========================================="
+echo "Building warpunk_bench (Executable)"
+echo "========================================="
+
+BENCH_OBJS=""
+for src in $(find "$BENCH_SRC_DIR" -name "*.cpp"); do
+    obj="$BENCH_DIR/warpunk.bench/$(basename "$src" .cpp).o"
+    echo "Compiling $src"
+    $CXX $CXXFLAGS -DWARPUNK_IMPORT=1 $INCLUDES -c "$src" -o "$obj"
+    BENCH_OBJS="$BENCH_OBJS $obj"
+done
+
+$CXX -o "$BENCH_DIR/warpunk_bench" $BENCH_OBJS \
+    -L"$BENCH_DIR" -Wl,-rpath,'$ORIGIN' \
+    -lwarpunk.core $LIBS
+
+# ================================
+# Done
+# ================================
+echo
+echo "========================================="
+echo "Build complete!"
+echo "  → $BENCH_DIR/warpunk_bench"
+echo "  Run: $BENCH_DIR/warpunk_bench --output bench.json"
+echo "========================================="
@@ -27,7 +27,7 @@ set "INCLUDES=-I%SCRIPT_DIR% -I%SCRIPT_DIR%\warpunk.core -I%SCRIPT_DIR%\warpunk.
 :: Vulkan SDK configuration
 set "VULKAN_SDK=C:\VulkanSDK\1.4.313.0"
 set "INCLUDES=%INCLUDES% -I%VULKAN_SDK%\Include"
-set "LIBS=-L%VULKAN_SDK%\Lib -lvulkan-1 -luser32 -lgdi32 -lwinmm"
+set "LIBS=-L%VULKAN_SDK%\Lib -lvulkan-1 -luser32 -lgdi32 -lwinmm -lsynchronization"
 
 :: ===================================================
 :: Build warpunk.core DLL
@@ -11,12 +11,12 @@ b8 update(application* app)
     return true;
 }
 
-b8 prepare_frame(application* app)
+b8 prepare_frame(application* app, frame_packet* packet)
 {
     return true;
 }
 
-b8 render_frame(application* app)
+b8 render_frame(application* app, const frame_packet* packet)
 {
     return true;
 }
@@ -0,0 +1,155 @@
+#include "warpunk.bench/src/bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+bench_stats bench_stats_compute(f64* samples, s64 sample_count)
+{
+    bench_stats stats = {};
+    stats.sample_count = sample_count;
+    if (sample_count == 0)
+    {
+        return stats;
+    }
+
+    std::sort(samples, samples + sample_count);
+
+    f64 sum = 0.0;
+    for (s64 sample_idx = 0; sample_idx < sample_count; ++sample_idx)
+    {
+        sum += samples[sample_idx];
+    }
+
+    /** linear interpolation between the closest ranks */
+    auto percentile = [samples, sample_count](f64 p) -> f64
+    {
+        f64 rank = p * (sample_count - 1);
+        s64 lower = (s64)rank;
+        s64 upper = (lower + 1 < sample_count) ? lower + 1 : lower;
+        f64 fraction = rank - lower;
+        return samples[lower] + (samples[upper] - samples[lower]) * fraction;
+    };
+
+    stats.min = samples[0];
+    stats.max = samples[sample_count - 1];
+    stats.mean = sum / sample_count;
+    stats.p50 = percentile(0.50);
+    stats.p90 = percentile(0.90);
+    stats.p99 = percentile(0.99);
+    return stats;
+}
+
+b8 bench_is_selected(const bench_config* config, const char* name)
+{
+    return config->filter == nullptr || strstr(name, config->filter) != nullptr;
+}
+
+// JSON
+
+static void bench_json_key(bench_json* json, const char* key)
+{
+    if (json->needs_comma[json->depth])
+    {
+        fprintf(json->file, ",");
+    }
+    fprintf(json->file, "\n%*s", json->depth * 2, "");
+    if (key)
+    {
+        fprintf(json->file, "\"%s\": ", key);
+    }
+    json->needs_comma[json->depth] = true;
+}
+
+void bench_json_begin_object(bench_json* json, const char* key)
+{
+    if (json->depth > 0)
+    {
+        bench_json_key(json, key);
+    }
+    fprintf(json->file, "{");
+    json->needs_comma[++json->depth] = false;
+}
+
+void bench_json_end_object(bench_json* json)
+{
+    json->depth--;
+    fprintf(json->file, "\n%*s}", json->depth * 2, "");
+    if (json->depth == 0)
+    {
+        fprintf(json->file, "\n");
+    }
+}
+
+void bench_json_begin_array(bench_json* json, const char* key)
+{
+    bench_json_key(json, key);
+    fprintf(json->file, "[");
+    json->needs_comma[++json->depth] = false;
+}
+
+void bench_json_end_array(bench_json* json)
+{
+    json->depth--;
+    fprintf(json->file, "\n%*s]", json->depth * 2, "");
+}
+
+void bench_json_string(bench_json* json, const char* key, const char* value)
+{
+    bench_json_key(json, key);
+    fputc('"', json->file);
+    for (const char* cursor = value; *cursor != '\0'; ++cursor)
+    {
+        if (*cursor == '"' || *cursor == '\\')
+        {
+            fputc('\\', json->file);
+            fputc(*cursor, json->file);
+        }
+        else if ((u8)*cursor < 0x20)
+        {
+            fprintf(json->file, "\\u%04x", (u8)*cursor);
+        }
+        else
+        {
+            fputc(*cursor, json->file);
+        }
+    }
+    fputc('"', json->file);
+}
+
+void bench_json_number(bench_json* json, const char* key, f64 value)
+{
+    bench_json_key(json, key);
+    if (!std::isfinite(value))
+    {
+        /** JSON has no nan or inf */
+        fprintf(json->file, "null");
+        return;
+    }
+    fprintf(json->file, "%.9g", value);
+}
+
+void bench_json_integer(bench_json* json, const char* key, s64 value)
+{
+    bench_json_key(json, key);
+    fprintf(json->file, "%lld", (long long)value);
+}
+
+void bench_json_bool(bench_json* json, const char* key, b8 value)
+{
+    bench_json_key(json, key);
+    fprintf(json->file, value ? "true" : "false");
+}
+
+void bench_json_stats(bench_json* json, const char* key, const bench_stats* stats)
+{
+    bench_json_begin_object(json, key);
+    bench_json_integer(json, "samples", stats->sample_count);
+    bench_json_number(json, "min", stats->min);
+    bench_json_number(json, "mean", stats->mean);
+    bench_json_number(json, "p50", stats->p50);
+    bench_json_number(json, "p90", stats->p90);
+    bench_json_number(json, "p99", stats->p99);
+    bench_json_number(json, "max", stats->max);
+    bench_json_end_object(json);
+}
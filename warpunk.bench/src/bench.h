@@ -0,0 +1,94 @@
+#pragma once
+
+#include <warpunk.core/src/defines.h>
+#include <warpunk.core/src/container/dynarray.hpp>
+#include <warpunk.core/src/renderer/scene/scene.h>
+#include <warpunk.core/src/utils/logger.h>
+
+#include <stdio.h>
+
+/** @brief Summary of a series of timing samples. */
+typedef struct bench_stats
+{
+    s64 sample_count;
+    f64 min;
+    f64 mean;
+    f64 p50;
+    f64 p90;
+    f64 p99;
+    f64 max;
+} bench_stats;
+
+/** @brief Command line options shared by all benchmark groups. */
+typedef struct bench_config
+{
+    /** only run benchmarks whose name contains this string, nullptr runs all */
+    const char* filter;
+    /** timing samples per microbenchmark */
+    s32 micro_samples;
+    /** operations per microbenchmark sample */
+    s32 micro_iterations;
+    /** overrides the per scene frame count when > 0 */
+    s32 scene_frames;
+    /** skip the scenes with more than this many spheres, 0 runs all */
+    s64 max_scene_spheres;
+    /** scene file benchmarked as "scene.file" in addition to the generated scenes, nullptr for none */
+    const char* scene_path;
+    /** directory of the golden images, nullptr skips the golden comparison */
+    const char* golden_dir;
+    /** overwrite the goldens with the current renders instead of comparing */
+    b8 update_goldens;
+    /** largest accepted mean absolute channel difference (0-255) */
+    f64 golden_mean_tolerance;
+    /** largest accepted fraction of pixels that differ by more than 16 in any channel */
+    f64 golden_outlier_tolerance;
+} bench_config;
+
+/** seed of every generated benchmark scene, so results stay comparable between runs */
+#define BENCH_SCENE_SEED 1337
+
+/** @brief Builds the software renderer's four spheres for 4, otherwise a generated scene. */
+b8 bench_scene_create(scene* out_scene, s64 sphere_count, scene_distribution distribution);
+
+/** @brief Computes min/mean/percentiles/max, sorts `samples` in place. */
+bench_stats bench_stats_compute(f64* samples, s64 sample_count);
+
+/** @returns true if the benchmark `name` passes the configured filter. */
+b8 bench_is_selected(const bench_config* config, const char* name);
+
+/** @brief Console hook of the engine logs, they go to stderr so stdout stays valid JSON. */
+void bench_console_write(log_level level, const char* message);
+
+// JSON
+
+/** @brief Minimal streaming JSON writer, tracks whether a separator is needed. */
+typedef struct bench_json
+{
+    FILE* file;
+    s32 depth;
+    b8 needs_comma[16];
+} bench_json;
+
+void bench_json_begin_object(bench_json* json, const char* key);
+void bench_json_end_object(bench_json* json);
+void bench_json_begin_array(bench_json* json, const char* key);
+void bench_json_end_array(bench_json* json);
+void bench_json_string(bench_json* json, const char* key, const char* value);
+void bench_json_number(bench_json* json, const char* key, f64 value);
+void bench_json_integer(bench_json* json, const char* key, s64 value);
+void bench_json_bool(bench_json* json, const char* key, b8 value);
+void bench_json_stats(bench_json* json, const char* key, const bench_stats* stats);
+
+// GROUPS
+
+/** @brief Runs the hit/scatter/get_ray/rng/vector microbenchmarks. */
+void bench_run_micro(const bench_config* config, bench_json* json);
+
+/** @brief Renders the reference scenes end to end and reports frame times and rays per second. */
+void bench_run_scenes(const bench_config* config, bench_json* json);
+
+/** 
+ * @brief Renders the reference scenes deterministically and compares them against the goldens.
+ * @returns false if any scene is not reproducible or exceeds the tolerances.
+ */
+b8 bench_run_golden(const bench_config* config, bench_json* json);
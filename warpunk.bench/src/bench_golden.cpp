@@ -0,0 +1,241 @@
+#include "warpunk.bench/src/bench.h"
+
+#include <warpunk.core/src/platform/platform.h>
+#include <warpunk.core/src/renderer/camera/camera.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define GOLDEN_BYTES_PER_PIXEL 4
+#define GOLDEN_MAX_WIDTH 128
+#define GOLDEN_MAX_HEIGHT 72
+#define GOLDEN_OUTLIER_THRESHOLD 16
+#define GOLDEN_SEED 0x57415250554E4Bull
+
+typedef struct bench_golden_desc
+{
+    const char* name;
+    s64 sphere_count;
+    s32 image_width;
+    s32 samples_per_pixel;
+    s32 max_depth;
+    s32 frames;
+} bench_golden_desc;
+
+static const bench_golden_desc golden_descs[] = {
+    { "golden.four_spheres", 4,    96, 16, 50, 5 },
+    { "golden.random_1k",    1000, 96, 4,  10, 3 },
+};
+
+typedef struct golden_image
+{
+    s32 width;
+    s32 height;
+    /** tightly packed RGB8 */
+    u8 pixels[GOLDEN_MAX_WIDTH * GOLDEN_MAX_HEIGHT * 3];
+} golden_image;
+
+typedef struct golden_diff
+{
+    f64 mean_error;
+    s32 max_error;
+    f64 outlier_fraction;
+} golden_diff;
+
+/** converts the camera's packed ARGB8 output into RGB8 */
+static void golden_image_from_framebuffer(golden_image* image, const u8* framebuffer, s32 width, s32 height)
+{
+    image->width = width;
+    image->height = height;
+
+    const u32* pixels = (const u32 *)framebuffer;
+    for (s32 pixel_idx = 0; pixel_idx < width * height; ++pixel_idx)
+    {
+        u32 pixel = pixels[pixel_idx];
+        image->pixels[pixel_idx * 3 + 0] = (pixel >> 16) & 0xFF;
+        image->pixels[pixel_idx * 3 + 1] = (pixel >> 8) & 0xFF;
+        image->pixels[pixel_idx * 3 + 2] = pixel & 0xFF;
+    }
+}
+
+static b8 golden_image_write(const golden_image* image, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        WERROR("Failed to open %s for writing", path);
+        return false;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", image->width, image->height);
+    size_t size = (size_t)image->width * image->height * 3;
+    b8 result = fwrite(image->pixels, 1, size, file) == size;
+    fclose(file);
+    return result;
+}
+
+static b8 golden_image_read(golden_image* image, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        WERROR("Failed to open golden %s", path);
+        return false;
+    }
+
+    s32 max_value = 0;
+    if (fscanf(file, "P6 %d %d %d", &image->width, &image->height, &max_value) != 3 ||
+        max_value != 255 || fgetc(file) == EOF ||
+        image->width <= 0 || image->width > GOLDEN_MAX_WIDTH ||
+        image->height <= 0 || image->height > GOLDEN_MAX_HEIGHT)
+    {
+        WERROR("Golden %s is not an 8 bit binary PPM of at most %dx%d", path, GOLDEN_MAX_WIDTH, GOLDEN_MAX_HEIGHT);
+        fclose(file);
+        return false;
+    }
+
+    size_t size = (size_t)image->width * image->height * 3;
+    b8 result = fread(image->pixels, 1, size, file) == size;
+    fclose(file);
+    return result;
+}
+
+static golden_diff golden_image_compare(const golden_image* a, const golden_image* b)
+{
+    golden_diff diff = {};
+    s32 pixel_count = a->width * a->height;
+    s64 error_sum = 0;
+    s32 outlier_count = 0;
+    for (s32 pixel_idx = 0; pixel_idx < pixel_count; ++pixel_idx)
+    {
+        s32 pixel_max_error = 0;
+        for (s32 channel = 0; channel < 3; ++channel)
+        {
+            s32 error = abs((s32)a->pixels[pixel_idx * 3 + channel] - (s32)b->pixels[pixel_idx * 3 + channel]);
+            error_sum += error;
+            pixel_max_error = (error > pixel_max_error) ? error : pixel_max_error;
+        }
+
+        diff.max_error = (pixel_max_error > diff.max_error) ? pixel_max_error : diff.max_error;
+        if (pixel_max_error > GOLDEN_OUTLIER_THRESHOLD)
+        {
+            ++outlier_count;
+        }
+    }
+
+    diff.mean_error = (f64)error_sum / (pixel_count * 3);
+    diff.outlier_fraction = (f64)outlier_count / pixel_count;
+    return diff;
+}
+
+b8 bench_run_golden(const bench_config* config, bench_json* json)
+{
+    static u8 framebuffer[GOLDEN_MAX_WIDTH * GOLDEN_MAX_HEIGHT * GOLDEN_BYTES_PER_PIXEL];
+    golden_image* rendered = (golden_image *)WALLOC(sizeof(golden_image), MEMORY_TAG_APPLICATION);
+    golden_image* reference = (golden_image *)WALLOC(sizeof(golden_image), MEMORY_TAG_APPLICATION);
+
+    b8 all_passed = true;
+
+    bench_json_begin_array(json, "golden");
+    for (const bench_golden_desc& desc : golden_descs)
+    {
+        if (!bench_is_selected(config, desc.name))
+        {
+            continue;
+        }
+        fprintf(stderr, "golden %s\n", desc.name);
+
+        scene scene = {};
+        if (!bench_scene_create(&scene, desc.sphere_count, SCENE_DISTRIBUTION_UNIFORM))
+        {
+            all_passed = false;
+            continue;
+        }
+
+        camera_config camera_config = {
+            .aspect_ratio = 16.0 / 9.0,
+            .focal_length = 1.0,
+            .image_width = desc.image_width,
+            .viewport_height = 2.0,
+            .samples_per_pixel = desc.samples_per_pixel,
+            .max_depth = desc.max_depth,
+            .deterministic = true,
+            .seed = GOLDEN_SEED,
+        };
+        camera_handle camera = camera_create(camera_config);
+        s32 width;
+        s32 height;
+        camera_get_image_size(camera, &width, &height);
+
+        /** every frame has to match the first one bit for bit, otherwise the mode is not deterministic */
+        b8 is_deterministic = true;
+        dynarray<f64> frame_seconds = dynarray_create<f64>(desc.frames);
+        for (s32 frame = 0; frame < desc.frames; ++frame)
+        {
+            f64 start_time = platform_get_absolute_time();
+            camera_ray_cast(camera, scene.spheres.data, (s32)scene.spheres.size, framebuffer, 0.0);
+            frame_seconds.data[frame] = platform_get_absolute_time() - start_time;
+
+            if (frame == 0)
+            {
+                golden_image_from_framebuffer(rendered, framebuffer, width, height);
+            }
+            else
+            {
+                golden_image_from_framebuffer(reference, framebuffer, width, height);
+                is_deterministic &= memcmp(rendered->pixels, reference->pixels, (size_t)width * height * 3) == 0;
+            }
+        }
+        bench_stats stats = bench_stats_compute(frame_seconds.data, desc.frames);
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.ppm", config->golden_dir, desc.name);
+
+        b8 passed = is_deterministic;
+        golden_diff diff = {};
+        if (config->update_goldens)
+        {
+            passed &= golden_image_write(rendered, path);
+        }
+        else if (golden_image_read(reference, path) && reference->width == width && reference->height == height)
+        {
+            diff = golden_image_compare(rendered, reference);
+            passed &= diff.mean_error <= config->golden_mean_tolerance &&
+                      diff.outlier_fraction <= config->golden_outlier_tolerance;
+        }
+        else
+        {
+            passed = false;
+        }
+
+        if (!passed)
+        {
+            WERROR("%s failed: deterministic %d, mean error %.3f, outliers %.4f",
+                    desc.name, is_deterministic, diff.mean_error, diff.outlier_fraction);
+        }
+        all_passed &= passed;
+
+        bench_json_begin_object(json, nullptr);
+        bench_json_string(json, "name", desc.name);
+        bench_json_integer(json, "width", width);
+        bench_json_integer(json, "height", height);
+        bench_json_integer(json, "samples_per_pixel", desc.samples_per_pixel);
+        bench_json_stats(json, "frame_seconds", &stats);
+        bench_json_bool(json, "deterministic", is_deterministic);
+        bench_json_bool(json, "updated", config->update_goldens);
+        bench_json_number(json, "mean_error", diff.mean_error);
+        bench_json_integer(json, "max_error", diff.max_error);
+        bench_json_number(json, "outlier_fraction", diff.outlier_fraction);
+        bench_json_bool(json, "passed", passed);
+        bench_json_end_object(json);
+
+        dynarray_destroy(&frame_seconds);
+        camera_destroy(camera);
+        scene_destroy(&scene);
+    }
+    bench_json_end_array(json);
+
+    WFREE(reference);
+    WFREE(rendered);
+    return all_passed;
+}
@@ -0,0 +1,363 @@
+#include "warpunk.bench/src/bench.h"
+
+#include <warpunk.core/src/container/dynarray.hpp>
+#include <warpunk.core/src/container/hashmap.hpp>
+#include <warpunk.core/src/math/hittable.hpp>
+#include <warpunk.core/src/math/math_common.hpp>
+#include <warpunk.core/src/math/ray.hpp>
+#include <warpunk.core/src/math/v3.hpp>
+#include <warpunk.core/src/platform/platform.h>
+#include <warpunk.core/src/renderer/camera/camera.h>
+#include <warpunk.core/src/renderer/materials/material.hpp>
+#include <warpunk.core/src/utils/logger.h>
+
+/** results are folded into the sink so the measured work cannot be optimized away */
+static volatile f64 bench_sink;
+
+typedef f64 (*bench_micro_function)(s32 iterations);
+
+typedef struct bench_micro
+{
+    const char* name;
+    bench_micro_function function;
+} bench_micro;
+
+static sphere<f64> micro_sphere;
+static material<f64> micro_lambert = { .type = LAMBERT, .albedo = { 0.1, 0.2, 0.5 } };
+static material<f64> micro_metal = { .type = METAL, .fuzz = 0.33, .albedo = { 0.8, 0.8, 0.8 } };
+static material<f64> micro_dielectric = { .type = DIELECTRIC, .refraction_index = 1.5 };
+static hit_record<f64> micro_record;
+static camera_handle micro_camera;
+static hashmap<u64, u64> micro_map;
+
+/** a cache sized map, half of the lookups miss */
+#define BENCH_MAP_SIZE 4096
+
+// HIT
+
+static f64 bench_hit_sphere(s32 iterations)
+{
+    rayf64 ray = { .origin = { 0.0, 0.0, 0.0 }, .dir = { 0.01, -0.02, -1.0 } };
+    hit_record<f64> record = {};
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        ray.dir.x = (iteration & 15) * 0.001;
+        if (hit(&micro_sphere, &ray, { 0.001, inf64 }, &record))
+        {
+            result += record.t;
+        }
+    }
+    return result;
+}
+
+static f64 bench_miss_sphere(s32 iterations)
+{
+    rayf64 ray = { .origin = { 0.0, 0.0, 0.0 }, .dir = { 0.0, 1.0, 0.0 } };
+    hit_record<f64> record = {};
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        ray.dir.x = (iteration & 15) * 0.001;
+        result += hit(&micro_sphere, &ray, { 0.001, inf64 }, &record) ? 1.0 : 0.0;
+    }
+    return result;
+}
+
+// SCATTER
+
+static f64 bench_scatter(material<f64>* material, s32 iterations)
+{
+    rayf64 ray = { .origin = { 0.0, 0.0, 0.0 }, .dir = { 0.01, -0.02, -1.0 } };
+    rayf64 scattered = {};
+    v3f64 attenuation = {};
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        if (scatter(material, &ray, &micro_record, &attenuation, &scattered))
+        {
+            result += scattered.dir.x + attenuation.r;
+        }
+    }
+    return result;
+}
+
+static f64 bench_scatter_lambert(s32 iterations)
+{
+    return bench_scatter(&micro_lambert, iterations);
+}
+
+static f64 bench_scatter_metal(s32 iterations)
+{
+    return bench_scatter(&micro_metal, iterations);
+}
+
+static f64 bench_scatter_dielectric(s32 iterations)
+{
+    return bench_scatter(&micro_dielectric, iterations);
+}
+
+// CAMERA
+
+static f64 bench_get_ray(s32 iterations)
+{
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        rayf64 ray = camera_get_ray(micro_camera, iteration & 127, (iteration >> 7) & 63);
+        result += ray.dir.x;
+    }
+    return result;
+}
+
+// RNG
+
+static f64 bench_randreal01(s32 iterations)
+{
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        result += randreal01<f64>();
+    }
+    return result;
+}
+
+static f64 bench_random_unit_vector(s32 iterations)
+{
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        result += random_unit_vector<f64>().x;
+    }
+    return result;
+}
+
+// VECTOR
+
+static f64 bench_v3_dot(s32 iterations)
+{
+    v3f64 a = { 0.3, 0.5, 0.7 };
+    v3f64 b = { 0.2, 0.4, 0.6 };
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        a.x += 1e-9;
+        result += dot(a, b);
+    }
+    return result;
+}
+
+static f64 bench_v3_cross(s32 iterations)
+{
+    v3f64 a = { 0.3, 0.5, 0.7 };
+    v3f64 b = { 0.2, 0.4, 0.6 };
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        a.x += 1e-9;
+        result += cross(a, b).y;
+    }
+    return result;
+}
+
+static f64 bench_v3_unit_vector(s32 iterations)
+{
+    v3f64 a = { 0.3, 0.5, 0.7 };
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        a.x += 1e-9;
+        result += unit_vector(a).z;
+    }
+    return result;
+}
+
+static f64 bench_v3_madd(s32 iterations)
+{
+    v3f64 a = { 0.3, 0.5, 0.7 };
+    v3f64 b = { 0.2, 0.4, 0.6 };
+    v3f64 accumulator = zero<f64>();
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        accumulator += a * b + 0.5 * a;
+    }
+    return accumulator.x;
+}
+
+// CONTAINER
+
+/** the array starts empty every iteration, so the growth and relocation cost is part of the measurement */
+static f64 bench_dynarray_add(s32 iterations)
+{
+    dynarray<sphere<f64>> spheres = dynarray_empty<sphere<f64>>();
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        dynarray_add(&spheres, micro_sphere);
+    }
+    f64 result = spheres.data[iterations - 1].radius;
+    dynarray_destroy(&spheres);
+    return result;
+}
+
+static f64 bench_hashmap_get(s32 iterations)
+{
+    u64 result = 0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        u64* value = hashmap_get(&micro_map, (u64)(iteration & (2 * BENCH_MAP_SIZE - 1)));
+        result += (value != nullptr) ? *value : 1;
+    }
+    return (f64)result;
+}
+
+// CLOCK
+
+static f64 bench_clock_get_ticks(s32 iterations)
+{
+    u64 result = 0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        result += platform_get_ticks();
+    }
+    return (f64)result;
+}
+
+static f64 bench_clock_get_absolute_time(s32 iterations)
+{
+    f64 result = 0.0;
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        result += platform_get_absolute_time();
+    }
+    return result;
+}
+
+// LOGGER
+
+static void bench_discard_console_write([[maybe_unused]] log_level level, [[maybe_unused]] const char* message)
+{
+}
+
+/** includes the writer, the messages are flushed before the sample ends */
+static f64 bench_logger_info(s32 iterations)
+{
+    logger_console_write_hook_set(bench_discard_console_write);
+    for (s32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        WINFO("frame %d took %f ms", iteration, micro_record.t);
+    }
+    logger_flush();
+    logger_console_write_hook_set(bench_console_write);
+    return (f64)logger_dropped_count();
+}
+
+/** hardware events per operation over all samples, shows whether a kernel is compute, cache or branch bound */
+static void bench_json_counters(bench_json* json, const platform_perf_counters* start, const platform_perf_counters* end, f64 operation_count)
+{
+    f64 per_op[PLATFORM_PERF_COUNTER_COUNT];
+    for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+    {
+        per_op[counter] = (end->values[counter] - start->values[counter]) / operation_count;
+    }
+
+    bench_json_begin_object(json, "counters_per_op");
+    bench_json_number(json, "cycles", per_op[PLATFORM_PERF_COUNTER_CYCLES]);
+    bench_json_number(json, "instructions", per_op[PLATFORM_PERF_COUNTER_INSTRUCTIONS]);
+    bench_json_number(json, "ipc", per_op[PLATFORM_PERF_COUNTER_CYCLES] > 0.0
+            ? per_op[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / per_op[PLATFORM_PERF_COUNTER_CYCLES] : 0.0);
+    bench_json_number(json, "llc_misses", per_op[PLATFORM_PERF_COUNTER_LLC_MISSES]);
+    bench_json_number(json, "branch_misses", per_op[PLATFORM_PERF_COUNTER_BRANCH_MISSES]);
+    bench_json_number(json, "dtlb_misses", per_op[PLATFORM_PERF_COUNTER_DTLB_MISSES]);
+    bench_json_end_object(json);
+}
+
+static const bench_micro micro_benchmarks[] = {
+    { "hit.sphere_hit", bench_hit_sphere },
+    { "hit.sphere_miss", bench_miss_sphere },
+    { "scatter.lambert", bench_scatter_lambert },
+    { "scatter.metal", bench_scatter_metal },
+    { "scatter.dielectric", bench_scatter_dielectric },
+    { "camera.get_ray", bench_get_ray },
+    { "rng.randreal01", bench_randreal01 },
+    { "rng.random_unit_vector", bench_random_unit_vector },
+    { "v3.dot", bench_v3_dot },
+    { "v3.cross", bench_v3_cross },
+    { "v3.unit_vector", bench_v3_unit_vector },
+    { "v3.madd", bench_v3_madd },
+    { "dynarray.add", bench_dynarray_add },
+    { "hashmap.get", bench_hashmap_get },
+    { "clock.get_ticks", bench_clock_get_ticks },
+    { "clock.get_absolute_time", bench_clock_get_absolute_time },
+    { "logger.info", bench_logger_info },
+};
+
+void bench_run_micro(const bench_config* config, bench_json* json)
+{
+    micro_sphere = { .center = { 0.0, 0.0, -1.0 }, .radius = 0.5, .material = &micro_lambert };
+
+    micro_record = {};
+    micro_record.pos = { 0.0, 0.0, -0.5 };
+    micro_record.normal = { 0.0, 0.0, 1.0 };
+    micro_record.t = 0.5;
+    micro_record.front_face = true;
+
+    camera_config camera_config = {
+        .aspect_ratio = 2.0,
+        .focal_length = 1.0,
+        .image_width = 128,
+        .viewport_height = 2.0,
+        .samples_per_pixel = 1,
+        .max_depth = 1,
+    };
+    micro_camera = camera_create(camera_config);
+
+    micro_map = hashmap_create<u64, u64>(BENCH_MAP_SIZE);
+    for (u64 key = 0; key < BENCH_MAP_SIZE; ++key)
+    {
+        hashmap_insert(&micro_map, key * 2, key);
+    }
+
+    dynarray<f64> samples = dynarray_create<f64>(config->micro_samples);
+
+    bench_json_begin_array(json, "micro");
+    for (const bench_micro& micro : micro_benchmarks)
+    {
+        if (!bench_is_selected(config, micro.name))
+        {
+            continue;
+        }
+        fprintf(stderr, "micro %s\n", micro.name);
+
+        /** warm up caches and the branch predictor */
+        bench_sink = bench_sink + micro.function(config->micro_iterations);
+
+        platform_perf_counters start_counters;
+        b8 has_counters = platform_perf_counters_read(&start_counters);
+        for (s32 sample_idx = 0; sample_idx < config->micro_samples; ++sample_idx)
+        {
+            u64 start_ticks = platform_get_ticks();
+            bench_sink = bench_sink + micro.function(config->micro_iterations);
+            f64 elapsed_seconds = platform_ticks_to_seconds(platform_get_ticks() - start_ticks);
+            samples.data[sample_idx] = elapsed_seconds * 1e9 / config->micro_iterations;
+        }
+        platform_perf_counters end_counters;
+        has_counters = has_counters && platform_perf_counters_read(&end_counters);
+
+        bench_stats stats = bench_stats_compute(samples.data, config->micro_samples);
+
+        bench_json_begin_object(json, nullptr);
+        bench_json_string(json, "name", micro.name);
+        bench_json_integer(json, "iterations", config->micro_iterations);
+        bench_json_stats(json, "ns_per_op", &stats);
+        if (has_counters)
+        {
+            bench_json_counters(json, &start_counters, &end_counters, (f64)config->micro_samples * config->micro_iterations);
+        }
+        bench_json_end_object(json);
+    }
+    bench_json_end_array(json);
+
+    dynarray_destroy(&samples);
+    camera_destroy(micro_camera);
+    hashmap_destroy(&micro_map);
+}
@@ -0,0 +1,152 @@
+#include "warpunk.bench/src/bench.h"
+
+#include <warpunk.core/src/platform/platform.h>
+#include <warpunk.core/src/renderer/camera/camera.h>
+#include <warpunk.core/src/renderer/materials/material.hpp>
+
+#define BENCH_BYTES_PER_PIXEL 4
+
+typedef struct bench_scene_desc
+{
+    const char* name;
+    s64 sphere_count;
+    scene_distribution distribution;
+    s32 image_width;
+    s32 samples_per_pixel;
+    s32 max_depth;
+    s32 frames;
+} bench_scene_desc;
+
+/** resolution and samples shrink with scene size so every scene finishes in seconds */
+static const bench_scene_desc scene_descs[] = {
+    { "scene.four_spheres",       4,       SCENE_DISTRIBUTION_UNIFORM,      192, 8, 50, 10 },
+    { "scene.random_1k",          1000,    SCENE_DISTRIBUTION_UNIFORM,      128, 4, 10, 5 },
+    { "scene.random_10k",         10000,   SCENE_DISTRIBUTION_UNIFORM,      96,  2, 10, 5 },
+    { "scene.random_100k",        100000,  SCENE_DISTRIBUTION_UNIFORM,      64,  1, 10, 3 },
+    { "scene.random_1m",          1000000, SCENE_DISTRIBUTION_UNIFORM,      32,  1, 10, 3 },
+    { "scene.clustered_100k",     100000,  SCENE_DISTRIBUTION_CLUSTERED,    64,  1, 10, 3 },
+    { "scene.nested_glass_10k",   10000,   SCENE_DISTRIBUTION_NESTED_GLASS, 96,  2, 50, 3 },
+};
+
+/** the four spheres of the interactive software renderer */
+static b8 bench_scene_build_four_spheres(scene* scene)
+{
+    scene->materials = dynarray_create<material<f64>>(4);
+    scene->materials.data[0] = { .type = LAMBERT, .albedo = { 0.1, 0.2, 0.5 } };
+    scene->materials.data[1] = { .type = METAL, .albedo = { 0.8, 0.8, 0.8 } };
+    scene->materials.data[2] = { .type = DIELECTRIC, .refraction_index = (1.00 / 1.33) };
+    scene->materials.data[3] = { .type = METAL, .fuzz = 0.33, .albedo = { 0.33, 0.33, 0.33 } };
+
+    scene->spheres = dynarray_create<sphere<f64>>(4);
+    scene->spheres.data[0] = { .center = {  0.0,    0.0, -1.2 }, .radius =   0.5, .material = &scene->materials.data[0] };
+    scene->spheres.data[1] = { .center = { -1.0,    0.0, -1.0 }, .radius =   0.5, .material = &scene->materials.data[1] };
+    scene->spheres.data[2] = { .center = {  1.0,    0.0, -1.0 }, .radius =   0.5, .material = &scene->materials.data[2] };
+    scene->spheres.data[3] = { .center = {  0.0, -100.5, -1.0 }, .radius = 100.0, .material = &scene->materials.data[3] };
+    return true;
+}
+
+b8 bench_scene_create(scene* out_scene, s64 sphere_count, scene_distribution distribution)
+{
+    if (sphere_count == 4)
+    {
+        return bench_scene_build_four_spheres(out_scene);
+    }
+
+    scene_generator_config generator_config = {
+        .object_count = sphere_count,
+        .distribution = distribution,
+        .seed = BENCH_SCENE_SEED,
+    };
+    return scene_generate(out_scene, generator_config);
+}
+
+/** renders `scene` for `frames` timed frames and writes one entry of the "scenes" array */
+static void bench_run_scene(bench_json* json, const char* name, scene* scene,
+        s32 image_width, s32 samples_per_pixel, s32 max_depth, s32 frames)
+{
+    static u8 framebuffer[192 * 108 * BENCH_BYTES_PER_PIXEL];
+
+    camera_config camera_config = {
+        .aspect_ratio = 16.0 / 9.0,
+        .focal_length = 1.0,
+        .image_width = image_width,
+        .viewport_height = 2.0,
+        .samples_per_pixel = samples_per_pixel,
+        .max_depth = max_depth,
+    };
+    camera_handle camera = camera_create(camera_config);
+    s32 image_height;
+    camera_get_image_size(camera, &image_width, &image_height);
+
+    dynarray<f64> frame_seconds = dynarray_create<f64>(frames);
+
+    /** one untimed frame to fault in the scene and spin up the threads */
+    camera_ray_cast(camera, scene->spheres.data, (s32)scene->spheres.size, framebuffer, 0.0);
+    camera_reset_ray_count(camera);
+
+    f64 total_seconds = 0.0;
+    for (s32 frame = 0; frame < frames; ++frame)
+    {
+        f64 start_time = platform_get_absolute_time();
+        camera_ray_cast(camera, scene->spheres.data, (s32)scene->spheres.size, framebuffer, 0.0);
+        frame_seconds.data[frame] = platform_get_absolute_time() - start_time;
+        total_seconds += frame_seconds.data[frame];
+    }
+    u64 ray_count = camera_get_ray_count(camera);
+
+    bench_stats stats = bench_stats_compute(frame_seconds.data, frames);
+
+    bench_json_begin_object(json, nullptr);
+    bench_json_string(json, "name", name);
+    bench_json_integer(json, "spheres", scene->spheres.size);
+    bench_json_integer(json, "width", image_width);
+    bench_json_integer(json, "height", image_height);
+    bench_json_integer(json, "samples_per_pixel", samples_per_pixel);
+    bench_json_integer(json, "max_depth", max_depth);
+    bench_json_integer(json, "frames", frames);
+    bench_json_stats(json, "frame_seconds", &stats);
+    bench_json_integer(json, "rays", (s64)ray_count);
+    bench_json_number(json, "rays_per_second", total_seconds > 0.0 ? ray_count / total_seconds : 0.0);
+    bench_json_end_object(json);
+
+    dynarray_destroy(&frame_seconds);
+    camera_destroy(camera);
+}
+
+void bench_run_scenes(const bench_config* config, bench_json* json)
+{
+    bench_json_begin_array(json, "scenes");
+    for (const bench_scene_desc& desc : scene_descs)
+    {
+        if (!bench_is_selected(config, desc.name) ||
+            (config->max_scene_spheres > 0 && desc.sphere_count > config->max_scene_spheres))
+        {
+            continue;
+        }
+        fprintf(stderr, "scene %s\n", desc.name);
+
+        scene scene = {};
+        if (!bench_scene_create(&scene, desc.sphere_count, desc.distribution))
+        {
+            continue;
+        }
+
+        s32 frames = config->scene_frames > 0 ? config->scene_frames : desc.frames;
+        bench_run_scene(json, desc.name, &scene, desc.image_width, desc.samples_per_pixel, desc.max_depth, frames);
+        scene_destroy(&scene);
+    }
+
+    if (config->scene_path && bench_is_selected(config, "scene.file"))
+    {
+        fprintf(stderr, "scene.file %s\n", config->scene_path);
+
+        scene scene = {};
+        if (scene_load(&scene, config->scene_path))
+        {
+            s32 frames = config->scene_frames > 0 ? config->scene_frames : 3;
+            bench_run_scene(json, "scene.file", &scene, 64, 1, 10, frames);
+            scene_destroy(&scene);
+        }
+    }
+    bench_json_end_array(json);
+}
@@ -0,0 +1,245 @@
+#include "warpunk.bench/src/bench.h"
+
+#include <warpunk.core/src/utils/logger.h>
+#include <warpunk.core/src/utils/profiler.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FORMAT_VERSION 1
+
+void bench_console_write([[maybe_unused]] log_level level, const char* message)
+{
+    fputs(message, stderr);
+}
+
+static void bench_print_usage()
+{
+    fprintf(stderr,
+            "usage: warpunk_bench [options]\n"
+            "  --filter <substring>   run only benchmarks whose name contains substring\n"
+            "  --output <path>        write the JSON report to path instead of stdout\n"
+            "  --micro-samples <n>    timing samples per microbenchmark (default 50)\n"
+            "  --micro-iterations <n> operations per sample (default 100000)\n"
+            "  --frames <n>           frames per scene, overrides the per scene default\n"
+            "  --max-spheres <n>      skip scenes with more spheres than n\n"
+            "  --no-micro             skip the microbenchmarks\n"
+            "  --no-scenes            skip the end to end scenes\n"
+            "  --golden <dir>         render the reference scenes deterministically and compare them\n"
+            "                         against <dir>/<name>.ppm, exits with 2 on a mismatch\n"
+            "  --update-goldens       write the current renders to the golden directory instead\n"
+            "  --golden-tolerance <e> largest accepted mean channel error out of 255 (default 1.0)\n"
+            "  --scene <path>         also benchmark a scene file as scene.file\n"
+            "  --trace <path>         profile the run and write a Chrome trace to path\n"
+            "  --trace-counters       also sample the hardware counters of every traced zone\n"
+            "\n"
+            "usage: warpunk_bench --generate <path> [options]\n"
+            "  --count <n>            spheres including the ground (default 1000)\n"
+            "  --distribution <name>  uniform, clustered or nested_glass (default uniform)\n"
+            "  --seed <n>             generator seed (default 1337)\n");
+}
+
+int main(int argc, char** argv)
+{
+    logger_console_write_hook_set(bench_console_write);
+
+    bench_config config = {};
+    config.micro_samples = 50;
+    config.micro_iterations = 100000;
+    config.golden_mean_tolerance = 1.0;
+    config.golden_outlier_tolerance = 0.01;
+
+    const char* output_path = nullptr;
+    const char* generate_path = nullptr;
+    const char* trace_path = nullptr;
+    scene_generator_config generator_config = {};
+    generator_config.object_count = 1000;
+    generator_config.distribution = SCENE_DISTRIBUTION_UNIFORM;
+    generator_config.seed = BENCH_SCENE_SEED;
+    b8 run_micro = true;
+    b8 run_scenes = true;
+    profiler_config profiler_config = {};
+
+    for (s32 arg_idx = 1; arg_idx < argc; ++arg_idx)
+    {
+        const char* arg = argv[arg_idx];
+        const char* value = (arg_idx + 1 < argc) ? argv[arg_idx + 1] : nullptr;
+
+        if (strcmp(arg, "--no-micro") == 0)
+        {
+            run_micro = false;
+        }
+        else if (strcmp(arg, "--no-scenes") == 0)
+        {
+            run_scenes = false;
+        }
+        else if (strcmp(arg, "--trace-counters") == 0)
+        {
+            profiler_config.sample_counters = true;
+        }
+        else if (strcmp(arg, "--update-goldens") == 0)
+        {
+            config.update_goldens = true;
+        }
+        else if (value == nullptr)
+        {
+            bench_print_usage();
+            return 1;
+        }
+        else if (strcmp(arg, "--filter") == 0)
+        {
+            config.filter = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--output") == 0)
+        {
+            output_path = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--micro-samples") == 0)
+        {
+            config.micro_samples = atoi(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--micro-iterations") == 0)
+        {
+            config.micro_iterations = atoi(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--frames") == 0)
+        {
+            config.scene_frames = atoi(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--max-spheres") == 0)
+        {
+            config.max_scene_spheres = atoll(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--golden") == 0)
+        {
+            config.golden_dir = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--golden-tolerance") == 0)
+        {
+            config.golden_mean_tolerance = atof(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--scene") == 0)
+        {
+            config.scene_path = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--trace") == 0)
+        {
+            trace_path = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--generate") == 0)
+        {
+            generate_path = value;
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--count") == 0)
+        {
+            generator_config.object_count = atoll(value);
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--distribution") == 0)
+        {
+            if (!scene_distribution_from_string(value, &generator_config.distribution))
+            {
+                bench_print_usage();
+                return 1;
+            }
+            ++arg_idx;
+        }
+        else if (strcmp(arg, "--seed") == 0)
+        {
+            generator_config.seed = strtoull(value, nullptr, 0);
+            ++arg_idx;
+        }
+        else
+        {
+            bench_print_usage();
+            return 1;
+        }
+    }
+
+    if (config.micro_samples < 1 || config.micro_iterations < 1 ||
+        (config.update_goldens && config.golden_dir == nullptr))
+    {
+        bench_print_usage();
+        return 1;
+    }
+
+    if (generate_path)
+    {
+        scene scene = {};
+        if (!scene_generate(&scene, generator_config))
+        {
+            return 1;
+        }
+        b8 saved = scene_save(&scene, generate_path);
+        scene_destroy(&scene);
+        return saved ? 0 : 1;
+    }
+
+    bench_json json = {};
+    json.file = stdout;
+    if (output_path)
+    {
+        json.file = fopen(output_path, "w");
+        if (!json.file)
+        {
+            WERROR("Failed to open %s", output_path);
+            return 1;
+        }
+    }
+
+    logger_config logger_config = {};
+    logger_config.ring_size = 1024 * 1024;
+    logger_config.overflow_policy = LOG_OVERFLOW_POLICY_BLOCK;
+    logger_startup(logger_config);
+
+    if (trace_path)
+    {
+        profiler_startup(profiler_config);
+    }
+
+    bench_json_begin_object(&json, nullptr);
+    bench_json_integer(&json, "version", BENCH_FORMAT_VERSION);
+    bench_json_integer(&json, "timestamp", (s64)time(nullptr));
+    bench_json_string(&json, "filter", config.filter ? config.filter : "");
+
+    if (run_micro)
+    {
+        bench_run_micro(&config, &json);
+    }
+    if (run_scenes)
+    {
+        bench_run_scenes(&config, &json);
+    }
+    b8 golden_passed = true;
+    if (config.golden_dir)
+    {
+        golden_passed = bench_run_golden(&config, &json);
+    }
+
+    bench_json_end_object(&json);
+
+    if (trace_path)
+    {
+        profiler_export_chrome_trace(trace_path);
+        profiler_shutdown();
+    }
+    logger_shutdown();
+
+    if (output_path)
+    {
+        fclose(json.file);
+    }
+    return golden_passed ? 0 : 2;
+}
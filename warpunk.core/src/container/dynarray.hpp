@@ -2,46 +2,147 @@
 
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#define DYNARRAY_MIN_CAPACITY 8
+
+/**
+ * @brief Growable array, `size` elements are live and room for `capacity` is allocated.
+ * Trivially copyable elements are relocated with allocator_realloc, everything else is moved element by element.
+ */
 template<typename T>
 struct dynarray
 {
     s64 size;
     s64 capacity;
     T* data;
+    allocator allocator;
 };
 
+/** moves the live elements into a block of `capacity` */
 template<typename T>
-warpunk_api inline dynarray<T> dynarray_empty()
+inline b8 dynarray_relocate(dynarray<T>* array, s64 capacity)
+{
+    if (capacity == 0)
+    {
+        allocator_free(&array->allocator, array->data);
+        array->data = nullptr;
+        array->capacity = 0;
+        return true;
+    }
+
+    T* data = nullptr;
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        data = (T *)allocator_realloc(&array->allocator, array->data, sizeof(T) * array->capacity, sizeof(T) * capacity);
+        if (data == nullptr)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        data = (T *)allocator_alloc(&array->allocator, sizeof(T) * capacity);
+        if (data == nullptr)
+        {
+            return false;
+        }
+        for (s64 element_idx = 0; element_idx < array->size; ++element_idx)
+        {
+            new (&data[element_idx]) T(std::move(array->data[element_idx]));
+            array->data[element_idx].~T();
+        }
+        allocator_free(&array->allocator, array->data);
+    }
+
+    array->data = data;
+    array->capacity = capacity;
+    return true;
+}
+
+/** doubles the capacity until `size` elements fit */
+template<typename T>
+inline b8 dynarray_grow(dynarray<T>* array, s64 size)
+{
+    if (size <= array->capacity)
+    {
+        return true;
+    }
+
+    s64 capacity = (array->capacity > 0) ? array->capacity * 2 : DYNARRAY_MIN_CAPACITY;
+    capacity = (capacity < size) ? size : capacity;
+    return dynarray_relocate(array, capacity);
+}
+
+template<typename T>
+warpunk_api inline dynarray<T> dynarray_empty(allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
 {
     dynarray<T> array = {};
     array.size = 0;
     array.capacity = 0;
     array.data = nullptr;
+    array.allocator = allocator;
 
     return array;
 }
 
+/** Elements of trivial types are left uninitialized, use dynarray_create_zeroed if they are read before written. */
 template<typename T>
-warpunk_api inline dynarray<T> dynarray_create(u64 size)
+warpunk_api inline dynarray<T> dynarray_create(u64 size, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
 {
-    if (size == 0)
+    dynarray<T> array = dynarray_empty<T>(allocator);
+    if (size == 0 || !dynarray_relocate(&array, size))
     {
-        return dynarray_empty<T>();
+        return array;
+    }
+
+    for (s64 element_idx = 0; element_idx < (s64)size; ++element_idx)
+    {
+        new (&array.data[element_idx]) T;
+    }
+    array.size = size;
+    return array;
+}
+
+/** */
+template<typename T>
+warpunk_api inline dynarray<T> dynarray_create_zeroed(u64 size, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be zero initialized");
+
+    dynarray<T> array = dynarray_empty<T>(allocator);
+    if (size == 0 || !dynarray_relocate(&array, size))
+    {
+        return array;
     }
 
-    dynarray<T> array = {};
-    array.data = (T *)platform_memory_alloc(sizeof(T) * size); 
     platform_memory_zero(array.data, sizeof(T) * size);
     array.size = size;
-    array.capacity = size;
     return array;
 }
 
+template<typename T>
+warpunk_api inline void dynarray_clear(dynarray<T>* array)
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (s64 element_idx = 0; element_idx < array->size; ++element_idx)
+        {
+            array->data[element_idx].~T();
+        }
+    }
+    array->size = 0;
+}
+
 template<typename T>
 warpunk_api inline void dynarray_destroy(dynarray<T>* array)
 {
-    platform_memory_free(array->data);
+    dynarray_clear(array);
+    allocator_free(&array->allocator, array->data);
     array->data = nullptr;
     array->size = 0;
     array->capacity = 0;
@@ -65,89 +166,122 @@ warpunk_api inline T dynarray_back(dynarray<T>* array)
     {
         return T {};
     }
-    
-    return array->data[array->capacity-1];
+
+    return array->data[array->size-1];
+}
+
+/** Makes room for `capacity` elements without changing the size. */
+template<typename T>
+warpunk_api inline b8 dynarray_reserve(dynarray<T>* array, s64 capacity)
+{
+    if (capacity <= array->capacity)
+    {
+        return true;
+    }
+    return dynarray_relocate(array, capacity);
 }
 
+/** New elements of trivial types are left uninitialized, the capacity never shrinks. */
 template<typename T>
 warpunk_api inline b8 dynarray_resize(dynarray<T>* array, s64 size)
 {
-    if (array->data == nullptr)
+    if (!dynarray_grow(array, size))
     {
         return false;
     }
 
-    void* temp = platform_memory_alloc(sizeof(T) * size);
-    if (temp == nullptr)
+    for (s64 element_idx = array->size; element_idx < size; ++element_idx)
     {
-        return false;
-    } 
-    platform_memory_zero(temp, sizeof(T) * size);
-    platform_memory_copy(temp, array->data, sizeof(T) * size);
-    platform_memory_free(array->data);
-    array->data = (T *)temp;
+        new (&array->data[element_idx]) T;
+    }
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (s64 element_idx = size; element_idx < array->size; ++element_idx)
+        {
+            array->data[element_idx].~T();
+        }
+    }
     array->size = size;
 
     return true;
 }
 
+/** Like dynarray_resize, but new elements are zeroed. */
 template<typename T>
-warpunk_api inline b8 dynarrayhrink_to_fit(dynarray<T>* array)
+warpunk_api inline b8 dynarray_resize_zeroed(dynarray<T>* array, s64 size)
 {
-    return dynarray_resize(array, array->capacity);
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be zero initialized");
+
+    if (!dynarray_grow(array, size))
+    {
+        return false;
+    }
+
+    if (size > array->size)
+    {
+        platform_memory_zero(array->data + array->size, sizeof(T) * (size - array->size));
+    }
+    array->size = size;
+
+    return true;
 }
 
 template<typename T>
-warpunk_api inline void dynarray_add(dynarray<T>* array, T element)
+warpunk_api inline b8 dynarray_shrink_to_fit(dynarray<T>* array)
 {
-    if (array->size == 0)
+    if (array->size == array->capacity)
     {
-        array->data = (T *)platform_memory_alloc(sizeof(T) * 1); 
-        platform_memory_zero(array->data, sizeof(T) * 1);
-        array->size = 1;
-        array->capacity = 0;
+        return true;
     }
-    else if (array->capacity == array->size)
+    return dynarray_relocate(array, array->size);
+}
+
+/** Constructs the element in place. @returns the new element, nullptr if the array could not grow. */
+template<typename T, typename... Args>
+warpunk_api inline T* dynarray_emplace_back(dynarray<T>* array, Args&&... args)
+{
+    if (!dynarray_grow(array, array->size + 1))
     {
-        if (!dynarray_resize(array, array->size * 2))
-        {
-            // TODO: error
-            return;
-        }
+        return nullptr;
     }
 
-    array->data[array->capacity++] = element;
+    T* element = new (&array->data[array->size]) T(std::forward<Args>(args)...);
+    array->size++;
+    return element;
+}
+
+/** Amortized O(1), the capacity doubles when the array is full. */
+template<typename T>
+warpunk_api inline b8 dynarray_add(dynarray<T>* array, T element)
+{
+    return dynarray_emplace_back(array, std::move(element)) != nullptr;
 }
 
 template<typename T>
-warpunk_api inline void dynarray_remove(dynarray<T>* array)
+warpunk_api inline void dynarray_pop_back(dynarray<T>* array)
 {
-    if (array->capacity == 0)
+    if (array->size == 0)
     {
         return;
     }
-    array->data[array->capacity--] = T {};
+
+    array->size--;
+    array->data[array->size].~T();
 }
 
+/** Keeps the order of the remaining elements. */
 template<typename T>
 warpunk_api inline void dynarray_remove_at(dynarray<T>* array, s64 index)
 {
-    if (index >= array->size)
+    if (index < 0 || index >= array->size)
     {
         // TODO: error
         return;
     }
 
-    void* dst = ((T *)array->data) + index;
-    void* src = ((T *)array->data) + index+1;
-    platform_memory_copy(dst, src, sizeof(T) * (array->capacity - index));
-
-    array->data[array->capacity--] = T {};
-}
-
-template<typename T>
-warpunk_api inline void dynarray_clear(dynarray<T>* array)
-{
-    platform_memory_zero(array->data, sizeof(T) * array->size);
-    array->capacity = 0;
+    for (s64 element_idx = index; element_idx < array->size - 1; ++element_idx)
+    {
+        array->data[element_idx] = std::move(array->data[element_idx + 1]);
+    }
+    dynarray_pop_back(array);
 }
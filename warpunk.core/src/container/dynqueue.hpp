@@ -2,6 +2,7 @@
 
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
 
 /** */
 template<typename T>
@@ -12,11 +13,12 @@ struct dynqueue
     T* data;
     s64 head;
     s64 tail;
+    allocator allocator;
 };
 
 /** */
 template<typename T>
-warpunk_api inline dynqueue<T> dynqueue_create(s64 size)
+warpunk_api inline dynqueue<T> dynqueue_create(s64 size, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
 {
     if (size <= 0)
     {
@@ -26,7 +28,8 @@ warpunk_api inline dynqueue<T> dynqueue_create(s64 size)
     dynqueue<T> queue = {};
     queue.size = size;
     queue.capacity = 0;
-    queue.data = (T *)platform_memory_alloc(sizeof(T) * size);
+    queue.allocator = allocator;
+    queue.data = (T *)allocator_alloc(&allocator, sizeof(T) * size);
     platform_memory_zero(queue.data, sizeof(T) * size);
     queue.head = 0;
     queue.tail = 0;
@@ -37,7 +40,7 @@ warpunk_api inline dynqueue<T> dynqueue_create(s64 size)
 template<typename T>
 warpunk_api inline void dynqueue_destroy(dynqueue<T>* queue)
 {
-    platform_memory_free(queue->data);
+    allocator_free(&queue->allocator, queue->data);
     queue->size = 0;
     queue->capacity = 0;
     queue->data = nullptr;
@@ -55,7 +58,7 @@ warpunk_api inline b8 dynqueue_enqueue(dynqueue<T>* queue, T element)
     s64 next_element = (queue->tail + 1) % queue->size;
     if (next_element == queue->head)
     {
-        void* temp = platform_memory_alloc(sizeof(T) * queue->size * 2); 
+        void* temp = allocator_alloc(&queue->allocator, sizeof(T) * queue->size * 2); 
         T* temp_typed = (T *)temp;
         if (temp == nullptr)
         {
@@ -68,7 +71,7 @@ warpunk_api inline b8 dynqueue_enqueue(dynqueue<T>* queue, T element)
         temp_typed += queue->size - queue->head;
         /** copy rest */
         platform_memory_copy(temp_typed, queue->data, sizeof(T) * (queue->tail + 1));
-        platform_memory_free(queue->data);
+        allocator_free(&queue->allocator, queue->data);
         queue->head = 0;
         queue->size *= 2;
         queue->tail = queue->capacity;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+
+#include <string.h>
+#include <type_traits>
+
+/** @brief Non owning string slice, looks up `const char*` keys without a terminator or a copy. */
+typedef struct strview
+{
+    const char* data;
+    s64 length;
+} strview;
+
+/** */
+inline strview strview_from(const char* string)
+{
+    return strview { string, (string != nullptr) ? (s64)strlen(string) : 0 };
+}
+
+/** murmur3 finalizer, every input bit reaches the low 7 bits and the probe position */
+inline u64 hash_mix(u64 value)
+{
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+/** eight bytes per step, C strings and slices of the same characters hash the same */
+inline u64 hash_bytes(const void* data, s64 length)
+{
+    const u8* bytes = (const u8 *)data;
+    u64 hash = 0x9E3779B97F4A7C15ull ^ (u64)length;
+    while (length >= 8)
+    {
+        u64 chunk;
+        memcpy(&chunk, bytes, 8);
+        hash = hash_mix(hash ^ chunk);
+        bytes += 8;
+        length -= 8;
+    }
+
+    u64 tail = 0;
+    memcpy(&tail, bytes, length);
+    return hash_mix(hash ^ tail);
+}
+
+/**
+ * @brief Hash and equality of a key type. Specialize it for new key types, extra `hash` and `equal`
+ * overloads make lookups with other types possible (e.g. a strview for a `const char*` key).
+ */
+template<typename K, typename Enable = void>
+struct hash_traits;
+
+template<typename K>
+struct hash_traits<K, std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K>>>
+{
+    static u64 hash(K key) { return hash_mix((u64)key); }
+    static b8 equal(K a, K b) { return a == b; }
+};
+
+template<typename K>
+struct hash_traits<K*, std::enable_if_t<!std::is_same_v<std::remove_cv_t<K>, char>>>
+{
+    static u64 hash(const K* key) { return hash_mix((u64)(uintptr_t)key); }
+    static b8 equal(const K* a, const K* b) { return a == b; }
+};
+
+/** C string keys are compared by content, the map does not copy them so they have to outlive it */
+template<typename K>
+struct hash_traits<K*, std::enable_if_t<std::is_same_v<std::remove_cv_t<K>, char>>>
+{
+    static u64 hash(const char* key) { return hash_bytes(key, strlen(key)); }
+    static u64 hash(strview key) { return hash_bytes(key.data, key.length); }
+    static b8 equal(const char* a, const char* b) { return strcmp(a, b) == 0; }
+    static b8 equal(const char* a, strview b) { return strncmp(a, b.data, b.length) == 0 && a[b.length] == '\0'; }
+};
+
+template<>
+struct hash_traits<strview>
+{
+    static u64 hash(strview key) { return hash_bytes(key.data, key.length); }
+    static u64 hash(const char* key) { return hash_bytes(key, strlen(key)); }
+    static b8 equal(strview a, strview b) { return a.length == b.length && memcmp(a.data, b.data, a.length) == 0; }
+    static b8 equal(strview a, const char* b) { return strncmp(b, a.data, a.length) == 0 && b[a.length] == '\0'; }
+};
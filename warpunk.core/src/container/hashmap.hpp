@@ -0,0 +1,421 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
+#include "warpunk.core/src/container/hash.hpp"
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define HASHTABLE_SSE2
+#endif
+
+/**
+ * Swiss table layout: one control byte per slot holds the low 7 bits of the hash while the slot is full,
+ * so a lookup compares a whole group of 16 control bytes at once and only touches slots whose byte matches.
+ */
+#define HASHTABLE_GROUP_WIDTH 16
+#define HASHTABLE_MIN_CAPACITY 16
+#define HASHTABLE_CTRL_EMPTY ((s8)-128)
+#define HASHTABLE_CTRL_DELETED ((s8)-2)
+
+/** one bit per control byte of a group, the lowest bit is the first slot */
+typedef u32 hashtable_mask;
+
+/** the group starting at `ctrl`, the control bytes are mirrored past the end so it may wrap */
+inline hashtable_mask hashtable_group_match(const s8* ctrl, s8 value)
+{
+#ifdef HASHTABLE_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+    return (hashtable_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#else
+    hashtable_mask mask = 0;
+    for (s32 byte_idx = 0; byte_idx < HASHTABLE_GROUP_WIDTH; ++byte_idx)
+    {
+        mask |= (hashtable_mask)(ctrl[byte_idx] == value) << byte_idx;
+    }
+    return mask;
+#endif
+}
+
+/** empty and deleted bytes are the only ones with the sign bit set */
+inline hashtable_mask hashtable_group_match_free(const s8* ctrl)
+{
+#ifdef HASHTABLE_SSE2
+    return (hashtable_mask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+    hashtable_mask mask = 0;
+    for (s32 byte_idx = 0; byte_idx < HASHTABLE_GROUP_WIDTH; ++byte_idx)
+    {
+        mask |= (hashtable_mask)(ctrl[byte_idx] < 0) << byte_idx;
+    }
+    return mask;
+#endif
+}
+
+inline s32 hashtable_mask_first(hashtable_mask mask)
+{
+    return __builtin_ctz(mask);
+}
+
+/** keeps the mirrored copy of the first group in sync */
+inline void hashtable_set_ctrl(s8* ctrl, s64 capacity, s64 slot_idx, s8 value)
+{
+    ctrl[slot_idx] = value;
+    ctrl[((slot_idx - HASHTABLE_GROUP_WIDTH) & (capacity - 1)) + HASHTABLE_GROUP_WIDTH] = value;
+}
+
+/** a table is never filled past 7/8 */
+inline s64 hashtable_max_size(s64 capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/** first free slot on the probe sequence of `hash` */
+inline s64 hashtable_find_free(const s8* ctrl, s64 capacity, u64 hash)
+{
+    s64 mask = capacity - 1;
+    s64 position = (s64)(hash >> 7) & mask;
+    for (s64 probe = HASHTABLE_GROUP_WIDTH; ; probe += HASHTABLE_GROUP_WIDTH)
+    {
+        hashtable_mask free_mask = hashtable_group_match_free(ctrl + position);
+        if (free_mask != 0)
+        {
+            return (position + hashtable_mask_first(free_mask)) & mask;
+        }
+        position = (position + probe) & mask;
+    }
+}
+
+template<typename K, typename V>
+struct hashmap_slot
+{
+    K key;
+    V value;
+};
+
+/**
+ * @brief Open addressing hash map, keys and values are stored inline in one allocation together with the
+ * control bytes. Pointers into the map are only stable until the next insert. `hash_traits<K>` provides
+ * hashing and equality.
+ */
+template<typename K, typename V>
+struct hashmap
+{
+    /** `capacity` control bytes and HASHTABLE_GROUP_WIDTH mirrored ones */
+    s8* ctrl;
+    hashmap_slot<K, V>* slots;
+    s64 size;
+    s64 capacity;
+    /** inserts left before the table has to grow, deleted slots are not given back */
+    s64 growth_left;
+    allocator allocator;
+};
+
+/** control bytes first, the slots follow at their alignment */
+template<typename Slot>
+inline s64 hashtable_slots_offset(s64 capacity)
+{
+    static_assert(alignof(Slot) <= 16, "allocators only guarantee 16 byte alignment");
+    return (capacity + HASHTABLE_GROUP_WIDTH + alignof(Slot) - 1) & ~(s64)(alignof(Slot) - 1);
+}
+
+template<typename Slot>
+inline b8 hashtable_allocate(const allocator* allocator, s64 capacity, s8** out_ctrl, Slot** out_slots)
+{
+    s64 slots_offset = hashtable_slots_offset<Slot>(capacity);
+    u8* memory = (u8 *)allocator_alloc(allocator, slots_offset + sizeof(Slot) * capacity);
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    platform_memory_set(memory, capacity + HASHTABLE_GROUP_WIDTH, (u8)HASHTABLE_CTRL_EMPTY);
+    *out_ctrl = (s8 *)memory;
+    *out_slots = (Slot *)(memory + slots_offset);
+    return true;
+}
+
+/** @returns the slot of `key`, -1 if it is not in the table */
+template<typename K, typename Slot, typename Q>
+inline s64 hashtable_find(const s8* ctrl, const Slot* slots, s64 capacity, const Q& key, u64 hash)
+{
+    if (capacity == 0)
+    {
+        return -1;
+    }
+
+    s64 mask = capacity - 1;
+    s8 h2 = (s8)(hash & 0x7F);
+    s64 position = (s64)(hash >> 7) & mask;
+    for (s64 probe = HASHTABLE_GROUP_WIDTH; ; probe += HASHTABLE_GROUP_WIDTH)
+    {
+        const s8* group = ctrl + position;
+        for (hashtable_mask match = hashtable_group_match(group, h2); match != 0; match &= match - 1)
+        {
+            s64 slot_idx = (position + hashtable_mask_first(match)) & mask;
+            if (hash_traits<K>::equal(slots[slot_idx].key, key))
+            {
+                return slot_idx;
+            }
+        }
+        if (hashtable_group_match(group, HASHTABLE_CTRL_EMPTY) != 0)
+        {
+            return -1;
+        }
+        position = (position + probe) & mask;
+    }
+}
+
+/** moves every full slot into a fresh table of `capacity`, dropping the deleted ones */
+template<typename K, typename Slot>
+inline b8 hashtable_rehash(const allocator* allocator, s8** ctrl, Slot** slots, s64* current_capacity, s64 size,
+        s64* growth_left, s64 capacity)
+{
+    s8* new_ctrl = nullptr;
+    Slot* new_slots = nullptr;
+    if (!hashtable_allocate(allocator, capacity, &new_ctrl, &new_slots))
+    {
+        return false;
+    }
+
+    for (s64 slot_idx = 0; slot_idx < *current_capacity; ++slot_idx)
+    {
+        if ((*ctrl)[slot_idx] < 0)
+        {
+            continue;
+        }
+
+        Slot* slot = &(*slots)[slot_idx];
+        u64 hash = hash_traits<K>::hash(slot->key);
+        s64 new_slot_idx = hashtable_find_free(new_ctrl, capacity, hash);
+        hashtable_set_ctrl(new_ctrl, capacity, new_slot_idx, (s8)(hash & 0x7F));
+        new (&new_slots[new_slot_idx]) Slot(std::move(*slot));
+        slot->~Slot();
+    }
+
+    allocator_free(allocator, *ctrl);
+    *ctrl = new_ctrl;
+    *slots = new_slots;
+    *current_capacity = capacity;
+    *growth_left = hashtable_max_size(capacity) - size;
+    return true;
+}
+
+/**
+ * @returns the slot `key` is inserted into, its control byte is already set and `growth_left` counted.
+ * Grows the table when needed, -1 if that failed.
+ */
+template<typename K, typename Slot>
+inline s64 hashtable_prepare_insert(const allocator* allocator, s8** ctrl, Slot** slots, s64* capacity, s64 size,
+        s64* growth_left, u64 hash)
+{
+    s64 slot_idx = (*capacity > 0) ? hashtable_find_free(*ctrl, *capacity, hash) : -1;
+    if (slot_idx < 0 || (*growth_left == 0 && (*ctrl)[slot_idx] != HASHTABLE_CTRL_DELETED))
+    {
+        // a table that is mostly tombstones is cleaned up in place instead of doubled
+        s64 new_capacity = (*capacity == 0) ? HASHTABLE_MIN_CAPACITY :
+                           (size * 2 < hashtable_max_size(*capacity)) ? *capacity : *capacity * 2;
+        if (!hashtable_rehash<K>(allocator, ctrl, slots, capacity, size, growth_left, new_capacity))
+        {
+            return -1;
+        }
+        slot_idx = hashtable_find_free(*ctrl, *capacity, hash);
+    }
+
+    if ((*ctrl)[slot_idx] == HASHTABLE_CTRL_EMPTY)
+    {
+        (*growth_left)--;
+    }
+    hashtable_set_ctrl(*ctrl, *capacity, slot_idx, (s8)(hash & 0x7F));
+    return slot_idx;
+}
+
+/** @returns the next full slot after `*slot_idx`, start with -1 */
+inline s64 hashtable_next(const s8* ctrl, s64 capacity, s64 slot_idx)
+{
+    for (++slot_idx; slot_idx < capacity; ++slot_idx)
+    {
+        if (ctrl[slot_idx] >= 0)
+        {
+            return slot_idx;
+        }
+    }
+    return -1;
+}
+
+/** rounds `count` up to a power of two that holds it below the load factor */
+inline s64 hashtable_capacity_for(s64 count)
+{
+    s64 capacity = HASHTABLE_MIN_CAPACITY;
+    while (hashtable_max_size(capacity) < count)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+template<typename Slot>
+inline void hashtable_destroy_slots(const s8* ctrl, Slot* slots, s64 capacity)
+{
+    if constexpr (!std::is_trivially_destructible_v<Slot>)
+    {
+        for (s64 slot_idx = 0; slot_idx < capacity; ++slot_idx)
+        {
+            if (ctrl[slot_idx] >= 0)
+            {
+                slots[slot_idx].~Slot();
+            }
+        }
+    }
+}
+
+/** No memory is allocated until the first insert if `capacity` is 0. */
+template<typename K, typename V>
+warpunk_api inline hashmap<K, V> hashmap_create(s64 capacity = 0, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    hashmap<K, V> map = {};
+    map.allocator = allocator;
+    if (capacity > 0)
+    {
+        hashtable_rehash<K>(&map.allocator, &map.ctrl, &map.slots, &map.capacity, 0, &map.growth_left,
+                hashtable_capacity_for(capacity));
+    }
+    return map;
+}
+
+/** */
+template<typename K, typename V>
+warpunk_api inline void hashmap_destroy(hashmap<K, V>* map)
+{
+    hashtable_destroy_slots(map->ctrl, map->slots, map->capacity);
+    allocator_free(&map->allocator, map->ctrl);
+    map->ctrl = nullptr;
+    map->slots = nullptr;
+    map->size = 0;
+    map->capacity = 0;
+    map->growth_left = 0;
+}
+
+/** Keeps the memory. */
+template<typename K, typename V>
+warpunk_api inline void hashmap_clear(hashmap<K, V>* map)
+{
+    if (map->capacity == 0)
+    {
+        return;
+    }
+
+    hashtable_destroy_slots(map->ctrl, map->slots, map->capacity);
+    platform_memory_set(map->ctrl, map->capacity + HASHTABLE_GROUP_WIDTH, (u8)HASHTABLE_CTRL_EMPTY);
+    map->size = 0;
+    map->growth_left = hashtable_max_size(map->capacity);
+}
+
+/** Makes room for `count` entries without growing again. */
+template<typename K, typename V>
+warpunk_api inline b8 hashmap_reserve(hashmap<K, V>* map, s64 count)
+{
+    if (count <= map->size + map->growth_left)
+    {
+        return true;
+    }
+    return hashtable_rehash<K>(&map->allocator, &map->ctrl, &map->slots, &map->capacity, map->size,
+            &map->growth_left, hashtable_capacity_for(count));
+}
+
+/** `key` can be any type `hash_traits<K>` has `hash` and `equal` overloads for. @returns nullptr if missing. */
+template<typename K, typename V, typename Q>
+warpunk_api inline V* hashmap_get(hashmap<K, V>* map, const Q& key)
+{
+    s64 slot_idx = hashtable_find<K>(map->ctrl, map->slots, map->capacity, key, hash_traits<K>::hash(key));
+    return (slot_idx >= 0) ? &map->slots[slot_idx].value : nullptr;
+}
+
+template<typename K, typename V, typename Q>
+warpunk_api inline b8 hashmap_contains(hashmap<K, V>* map, const Q& key)
+{
+    return hashmap_get(map, key) != nullptr;
+}
+
+/** Overwrites the value if `key` is already in the map. @returns the stored value, nullptr if the map could not grow. */
+template<typename K, typename V>
+warpunk_api inline V* hashmap_insert(hashmap<K, V>* map, K key, V value)
+{
+    u64 hash = hash_traits<K>::hash(key);
+    s64 slot_idx = hashtable_find<K>(map->ctrl, map->slots, map->capacity, key, hash);
+    if (slot_idx >= 0)
+    {
+        map->slots[slot_idx].value = std::move(value);
+        return &map->slots[slot_idx].value;
+    }
+
+    slot_idx = hashtable_prepare_insert<K>(&map->allocator, &map->ctrl, &map->slots, &map->capacity, map->size,
+            &map->growth_left, hash);
+    if (slot_idx < 0)
+    {
+        return nullptr;
+    }
+
+    new (&map->slots[slot_idx]) hashmap_slot<K, V> { std::move(key), std::move(value) };
+    map->size++;
+    return &map->slots[slot_idx].value;
+}
+
+/** Like hashmap_insert, but a value already in the map is kept. `out_inserted` is optional. */
+template<typename K, typename V>
+warpunk_api inline V* hashmap_get_or_insert(hashmap<K, V>* map, K key, V value, b8* out_inserted = nullptr)
+{
+    u64 hash = hash_traits<K>::hash(key);
+    s64 slot_idx = hashtable_find<K>(map->ctrl, map->slots, map->capacity, key, hash);
+    if (out_inserted != nullptr)
+    {
+        *out_inserted = (slot_idx < 0);
+    }
+    if (slot_idx >= 0)
+    {
+        return &map->slots[slot_idx].value;
+    }
+
+    slot_idx = hashtable_prepare_insert<K>(&map->allocator, &map->ctrl, &map->slots, &map->capacity, map->size,
+            &map->growth_left, hash);
+    if (slot_idx < 0)
+    {
+        return nullptr;
+    }
+
+    new (&map->slots[slot_idx]) hashmap_slot<K, V> { std::move(key), std::move(value) };
+    map->size++;
+    return &map->slots[slot_idx].value;
+}
+
+/** @returns false if `key` was not in the map. */
+template<typename K, typename V, typename Q>
+warpunk_api inline b8 hashmap_remove(hashmap<K, V>* map, const Q& key)
+{
+    s64 slot_idx = hashtable_find<K>(map->ctrl, map->slots, map->capacity, key, hash_traits<K>::hash(key));
+    if (slot_idx < 0)
+    {
+        return false;
+    }
+
+    map->slots[slot_idx].~hashmap_slot<K, V>();
+    hashtable_set_ctrl(map->ctrl, map->capacity, slot_idx, HASHTABLE_CTRL_DELETED);
+    map->size--;
+    return true;
+}
+
+/**
+ * Iterates the entries in no particular order, start with `*slot_idx` at -1:
+ * `while (hashmap_slot<K, V>* slot = hashmap_next(&map, &slot_idx))`
+ */
+template<typename K, typename V>
+warpunk_api inline hashmap_slot<K, V>* hashmap_next(hashmap<K, V>* map, s64* slot_idx)
+{
+    *slot_idx = hashtable_next(map->ctrl, map->capacity, *slot_idx);
+    return (*slot_idx >= 0) ? &map->slots[*slot_idx] : nullptr;
+}
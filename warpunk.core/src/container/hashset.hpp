@@ -0,0 +1,130 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/container/hashmap.hpp"
+
+/** keys only, so the set probes exactly like the map */
+template<typename K>
+struct hashset_slot
+{
+    K key;
+};
+
+/** @brief Open addressing hash set, see hashmap. */
+template<typename K>
+struct hashset
+{
+    s8* ctrl;
+    hashset_slot<K>* slots;
+    s64 size;
+    s64 capacity;
+    s64 growth_left;
+    allocator allocator;
+};
+
+/** No memory is allocated until the first insert if `capacity` is 0. */
+template<typename K>
+warpunk_api inline hashset<K> hashset_create(s64 capacity = 0, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    hashset<K> set = {};
+    set.allocator = allocator;
+    if (capacity > 0)
+    {
+        hashtable_rehash<K>(&set.allocator, &set.ctrl, &set.slots, &set.capacity, 0, &set.growth_left,
+                hashtable_capacity_for(capacity));
+    }
+    return set;
+}
+
+/** */
+template<typename K>
+warpunk_api inline void hashset_destroy(hashset<K>* set)
+{
+    hashtable_destroy_slots(set->ctrl, set->slots, set->capacity);
+    allocator_free(&set->allocator, set->ctrl);
+    set->ctrl = nullptr;
+    set->slots = nullptr;
+    set->size = 0;
+    set->capacity = 0;
+    set->growth_left = 0;
+}
+
+/** Keeps the memory. */
+template<typename K>
+warpunk_api inline void hashset_clear(hashset<K>* set)
+{
+    if (set->capacity == 0)
+    {
+        return;
+    }
+
+    hashtable_destroy_slots(set->ctrl, set->slots, set->capacity);
+    platform_memory_set(set->ctrl, set->capacity + HASHTABLE_GROUP_WIDTH, (u8)HASHTABLE_CTRL_EMPTY);
+    set->size = 0;
+    set->growth_left = hashtable_max_size(set->capacity);
+}
+
+/** */
+template<typename K>
+warpunk_api inline b8 hashset_reserve(hashset<K>* set, s64 count)
+{
+    if (count <= set->size + set->growth_left)
+    {
+        return true;
+    }
+    return hashtable_rehash<K>(&set->allocator, &set->ctrl, &set->slots, &set->capacity, set->size,
+            &set->growth_left, hashtable_capacity_for(count));
+}
+
+/** `key` can be any type `hash_traits<K>` has `hash` and `equal` overloads for. */
+template<typename K, typename Q>
+warpunk_api inline b8 hashset_contains(hashset<K>* set, const Q& key)
+{
+    return hashtable_find<K>(set->ctrl, set->slots, set->capacity, key, hash_traits<K>::hash(key)) >= 0;
+}
+
+/** @returns false if `key` was already in the set or the set could not grow. */
+template<typename K>
+warpunk_api inline b8 hashset_insert(hashset<K>* set, K key)
+{
+    u64 hash = hash_traits<K>::hash(key);
+    if (hashtable_find<K>(set->ctrl, set->slots, set->capacity, key, hash) >= 0)
+    {
+        return false;
+    }
+
+    s64 slot_idx = hashtable_prepare_insert<K>(&set->allocator, &set->ctrl, &set->slots, &set->capacity, set->size,
+            &set->growth_left, hash);
+    if (slot_idx < 0)
+    {
+        return false;
+    }
+
+    new (&set->slots[slot_idx]) hashset_slot<K> { std::move(key) };
+    set->size++;
+    return true;
+}
+
+/** @returns false if `key` was not in the set. */
+template<typename K, typename Q>
+warpunk_api inline b8 hashset_remove(hashset<K>* set, const Q& key)
+{
+    s64 slot_idx = hashtable_find<K>(set->ctrl, set->slots, set->capacity, key, hash_traits<K>::hash(key));
+    if (slot_idx < 0)
+    {
+        return false;
+    }
+
+    set->slots[slot_idx].~hashset_slot<K>();
+    hashtable_set_ctrl(set->ctrl, set->capacity, slot_idx, HASHTABLE_CTRL_DELETED);
+    set->size--;
+    return true;
+}
+
+/** Iterates the keys in no particular order, start with `*slot_idx` at -1. */
+template<typename K>
+warpunk_api inline const K* hashset_next(hashset<K>* set, s64* slot_idx)
+{
+    *slot_idx = hashtable_next(set->ctrl, set->capacity, *slot_idx);
+    return (*slot_idx >= 0) ? &set->slots[*slot_idx].key : nullptr;
+}
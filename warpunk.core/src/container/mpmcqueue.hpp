@@ -0,0 +1,177 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+#include <type_traits>
+
+/**
+ * Bounded multi producer multi consumer queue after Dmitry Vyukov. Every cell carries a sequence number:
+ * cell i is free for the producer of position p when sequence == p, and holds data for the consumer of
+ * position p when sequence == p + 1. Producers and consumers only contend on their own position counter.
+ */
+template<typename T>
+struct mpmcqueue_cell
+{
+    u64 sequence;
+    T data;
+};
+
+/** @brief Lock free bounded queue for any number of producer and consumer threads. */
+template<typename T>
+struct mpmcqueue
+{
+    alignas(CACHE_LINE_SIZE) u64 enqueue_position;
+    alignas(CACHE_LINE_SIZE) u64 dequeue_position;
+
+    alignas(CACHE_LINE_SIZE) mpmcqueue_cell<T>* cells;
+    u64 mask;
+    allocator allocator;
+};
+
+/** `capacity` is rounded up to a power of two. The queue must not be moved while threads use it. */
+template<typename T>
+warpunk_api inline b8 mpmcqueue_create(mpmcqueue<T>* out_queue, s64 capacity, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    static_assert(std::is_trivially_copyable_v<T>, "queue elements are copied as raw memory");
+
+    u64 rounded_capacity = 2;
+    while (rounded_capacity < (u64)capacity)
+    {
+        rounded_capacity *= 2;
+    }
+
+    *out_queue = {};
+    out_queue->allocator = allocator;
+    out_queue->cells = (mpmcqueue_cell<T> *)allocator_alloc(&out_queue->allocator, sizeof(mpmcqueue_cell<T>) * rounded_capacity);
+    if (out_queue->cells == nullptr)
+    {
+        return false;
+    }
+
+    for (u64 cell_idx = 0; cell_idx < rounded_capacity; ++cell_idx)
+    {
+        out_queue->cells[cell_idx].sequence = cell_idx;
+    }
+    out_queue->mask = rounded_capacity - 1;
+    return true;
+}
+
+/** */
+template<typename T>
+warpunk_api inline void mpmcqueue_destroy(mpmcqueue<T>* queue)
+{
+    allocator_free(&queue->allocator, queue->cells);
+    *queue = {};
+}
+
+/**
+ * Claims up to `count` consecutive free cells with a single compare and swap.
+ * @returns the number of elements pushed, 0 if the queue is full.
+ */
+template<typename T>
+warpunk_api inline s64 mpmcqueue_push_batch(mpmcqueue<T>* queue, const T* elements, s64 count)
+{
+    u64 position = __atomic_load_n(&queue->enqueue_position, __ATOMIC_RELAXED);
+    while (true)
+    {
+        s64 free_count = 0;
+        while (free_count < count)
+        {
+            mpmcqueue_cell<T>* cell = &queue->cells[(position + free_count) & queue->mask];
+            if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != position + free_count)
+            {
+                break;
+            }
+            free_count++;
+        }
+
+        if (free_count == 0)
+        {
+            u64 current_position = __atomic_load_n(&queue->enqueue_position, __ATOMIC_RELAXED);
+            mpmcqueue_cell<T>* cell = &queue->cells[position & queue->mask];
+            if (current_position == position && (s64)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - position) < 0)
+            {
+                // the cell still holds the element of the previous lap
+                return 0;
+            }
+            position = current_position;
+            continue;
+        }
+
+        if (__atomic_compare_exchange_n(&queue->enqueue_position, &position, position + free_count, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            for (s64 element_idx = 0; element_idx < free_count; ++element_idx)
+            {
+                mpmcqueue_cell<T>* cell = &queue->cells[(position + element_idx) & queue->mask];
+                cell->data = elements[element_idx];
+                __atomic_store_n(&cell->sequence, position + element_idx + 1, __ATOMIC_RELEASE);
+            }
+            return free_count;
+        }
+    }
+}
+
+/** @returns false if the queue is full. */
+template<typename T>
+warpunk_api inline b8 mpmcqueue_push(mpmcqueue<T>* queue, T element)
+{
+    return mpmcqueue_push_batch(queue, &element, 1) == 1;
+}
+
+/**
+ * Claims up to `max_count` consecutive filled cells with a single compare and swap.
+ * @returns the number of elements written to `out_elements`, 0 if the queue is empty.
+ */
+template<typename T>
+warpunk_api inline s64 mpmcqueue_pop_batch(mpmcqueue<T>* queue, T* out_elements, s64 max_count)
+{
+    u64 position = __atomic_load_n(&queue->dequeue_position, __ATOMIC_RELAXED);
+    while (true)
+    {
+        s64 ready_count = 0;
+        while (ready_count < max_count)
+        {
+            mpmcqueue_cell<T>* cell = &queue->cells[(position + ready_count) & queue->mask];
+            if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != position + ready_count + 1)
+            {
+                break;
+            }
+            ready_count++;
+        }
+
+        if (ready_count == 0)
+        {
+            u64 current_position = __atomic_load_n(&queue->dequeue_position, __ATOMIC_RELAXED);
+            mpmcqueue_cell<T>* cell = &queue->cells[position & queue->mask];
+            if (current_position == position && (s64)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (position + 1)) < 0)
+            {
+                // nothing was pushed to this cell yet
+                return 0;
+            }
+            position = current_position;
+            continue;
+        }
+
+        if (__atomic_compare_exchange_n(&queue->dequeue_position, &position, position + ready_count, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            for (s64 element_idx = 0; element_idx < ready_count; ++element_idx)
+            {
+                mpmcqueue_cell<T>* cell = &queue->cells[(position + element_idx) & queue->mask];
+                out_elements[element_idx] = cell->data;
+                __atomic_store_n(&cell->sequence, position + element_idx + queue->mask + 1, __ATOMIC_RELEASE);
+            }
+            return ready_count;
+        }
+    }
+}
+
+/** @returns false if the queue is empty. */
+template<typename T>
+warpunk_api inline b8 mpmcqueue_pop(mpmcqueue<T>* queue, T* out_element)
+{
+    return mpmcqueue_pop_batch(queue, out_element, 1) == 1;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+/** 
+ * a handle is the slot index in the low 16 bits and the slot's generation in the high 16 bits, 
+ * generations start at 1 so 0 is never a valid handle 
+ */
+typedef u32 slotmap_handle;
+
+#define SLOTMAP_INVALID_HANDLE 0
+#define SLOTMAP_MAX_CAPACITY 0xFFFE
+#define SLOTMAP_FREE_LIST_END 0xFFFF
+
+typedef struct slotmap_slot
+{
+    /** index into the dense arrays while the slot is live, the next free slot otherwise */
+    u16 index;
+    /** incremented on every remove, stale handles stop matching */
+    u16 generation;
+} slotmap_slot;
+
+/** 
+ * Fixed capacity container with O(1) insert, lookup and remove. The values stay packed in `data[0, size)`, 
+ * so live objects are iterated densely. Removing moves the last value into the hole, pointers into `data` 
+ * are only stable until the next remove.
+ */
+template<typename T>
+struct slotmap
+{
+    T* data;
+    /** slot of every dense value, patches the slot when its value moves */
+    u16* dense_slots;
+    slotmap_slot* slots;
+    s64 size;
+    s64 capacity;
+    u16 free_head;
+    allocator allocator;
+};
+
+/** */
+template<typename T>
+warpunk_api inline slotmap<T> slotmap_create(s64 capacity, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    capacity = (capacity > SLOTMAP_MAX_CAPACITY) ? SLOTMAP_MAX_CAPACITY : capacity;
+
+    slotmap<T> map = {};
+    map.allocator = allocator;
+    map.data = (T *)allocator_alloc(&allocator, sizeof(T) * capacity);
+    map.dense_slots = (u16 *)allocator_alloc(&allocator, sizeof(u16) * capacity);
+    map.slots = (slotmap_slot *)allocator_alloc(&allocator, sizeof(slotmap_slot) * capacity);
+    if (map.data == nullptr || map.dense_slots == nullptr || map.slots == nullptr)
+    {
+        return map;
+    }
+
+    map.capacity = capacity;
+    map.size = 0;
+    for (s64 slot_idx = 0; slot_idx < capacity; ++slot_idx)
+    {
+        map.slots[slot_idx].index = (slot_idx + 1 < capacity) ? (u16)(slot_idx + 1) : SLOTMAP_FREE_LIST_END;
+        map.slots[slot_idx].generation = 1;
+    }
+    map.free_head = (capacity > 0) ? 0 : SLOTMAP_FREE_LIST_END;
+    return map;
+}
+
+/** */
+template<typename T>
+warpunk_api inline void slotmap_destroy(slotmap<T>* map)
+{
+    allocator_free(&map->allocator, map->data);
+    allocator_free(&map->allocator, map->dense_slots);
+    allocator_free(&map->allocator, map->slots);
+    map->data = nullptr;
+    map->dense_slots = nullptr;
+    map->slots = nullptr;
+    map->size = 0;
+    map->capacity = 0;
+    map->free_head = SLOTMAP_FREE_LIST_END;
+}
+
+/** @returns the handle of the new value, SLOTMAP_INVALID_HANDLE if the map is full. */
+template<typename T>
+warpunk_api inline slotmap_handle slotmap_insert(slotmap<T>* map, T value)
+{
+    if (map->free_head == SLOTMAP_FREE_LIST_END)
+    {
+        return SLOTMAP_INVALID_HANDLE;
+    }
+
+    u16 slot_idx = map->free_head;
+    slotmap_slot* slot = &map->slots[slot_idx];
+    map->free_head = slot->index;
+
+    slot->index = (u16)map->size;
+    map->data[map->size] = value;
+    map->dense_slots[map->size] = slot_idx;
+    map->size++;
+
+    return ((slotmap_handle)slot->generation << 16) | slot_idx;
+}
+
+/** @returns the value of `handle`, nullptr if the handle was removed or never existed. */
+template<typename T>
+warpunk_api inline T* slotmap_get(slotmap<T>* map, slotmap_handle handle)
+{
+    u32 slot_idx = handle & 0xFFFF;
+    u16 generation = (u16)(handle >> 16);
+    if (slot_idx >= map->capacity || map->slots[slot_idx].generation != generation)
+    {
+        return nullptr;
+    }
+
+    /** a free slot can carry a matching generation too, its index is then a free list link */
+    u16 dense_idx = map->slots[slot_idx].index;
+    if (dense_idx >= map->size || map->dense_slots[dense_idx] != slot_idx)
+    {
+        return nullptr;
+    }
+
+    return &map->data[dense_idx];
+}
+
+/** @returns the handle of the value at `dense_index`, to go from dense iteration back to handles. */
+template<typename T>
+warpunk_api inline slotmap_handle slotmap_handle_at(slotmap<T>* map, s64 dense_index)
+{
+    u16 slot_idx = map->dense_slots[dense_index];
+    return ((slotmap_handle)map->slots[slot_idx].generation << 16) | slot_idx;
+}
+
+/** @returns false if `handle` is stale or never existed. */
+template<typename T>
+warpunk_api inline b8 slotmap_remove(slotmap<T>* map, slotmap_handle handle)
+{
+    T* value = slotmap_get(map, handle);
+    if (value == nullptr)
+    {
+        return false;
+    }
+
+    u16 slot_idx = (u16)(handle & 0xFFFF);
+    slotmap_slot* slot = &map->slots[slot_idx];
+
+    /** move the last value into the hole and point its slot at the new position */
+    s64 last_idx = map->size - 1;
+    if (slot->index != last_idx)
+    {
+        map->data[slot->index] = map->data[last_idx];
+        map->dense_slots[slot->index] = map->dense_slots[last_idx];
+        map->slots[map->dense_slots[slot->index]].index = slot->index;
+    }
+    map->size--;
+
+    slot->generation = (slot->generation == 0xFFFF) ? 1 : slot->generation + 1;
+    slot->index = map->free_head;
+    map->free_head = slot_idx;
+    return true;
+}
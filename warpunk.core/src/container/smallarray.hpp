@@ -0,0 +1,152 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+#include <type_traits>
+
+/**
+ * @brief Growable array that keeps up to N elements inline and only spills to the allocator when it
+ * outgrows them. A zero initialized smallarray is empty and valid. Elements are copied as raw memory,
+ * so copying the struct while the elements are inline copies them too.
+ */
+template<typename T, s64 N>
+struct smallarray
+{
+    s64 size;
+    /** nullptr while the elements fit the inline storage */
+    T* heap_data;
+    s64 heap_capacity;
+    allocator allocator;
+    alignas(T) u8 inline_data[sizeof(T) * N];
+};
+
+template<typename T, s64 N>
+warpunk_api inline smallarray<T, N> smallarray_create(allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    static_assert(std::is_trivially_copyable_v<T>, "smallarray elements are copied as raw memory");
+
+    smallarray<T, N> array = {};
+    array.allocator = allocator;
+    return array;
+}
+
+/** */
+template<typename T, s64 N>
+warpunk_api inline void smallarray_destroy(smallarray<T, N>* array)
+{
+    allocator_free(&array->allocator, array->heap_data);
+    array->heap_data = nullptr;
+    array->heap_capacity = 0;
+    array->size = 0;
+}
+
+/** @returns the first element, the pointer changes when the array spills to the heap. */
+template<typename T, s64 N>
+warpunk_api inline T* smallarray_data(smallarray<T, N>* array)
+{
+    return (array->heap_data != nullptr) ? array->heap_data : (T *)array->inline_data;
+}
+
+template<typename T, s64 N>
+warpunk_api inline s64 smallarray_capacity(const smallarray<T, N>* array)
+{
+    return (array->heap_data != nullptr) ? array->heap_capacity : N;
+}
+
+/** Makes room for `capacity` elements, moving them to the heap if that is more than N. */
+template<typename T, s64 N>
+warpunk_api inline b8 smallarray_reserve(smallarray<T, N>* array, s64 capacity)
+{
+    if (capacity <= smallarray_capacity(array))
+    {
+        return true;
+    }
+
+    T* heap_data = nullptr;
+    if (array->heap_data != nullptr)
+    {
+        heap_data = (T *)allocator_realloc(&array->allocator, array->heap_data, sizeof(T) * array->heap_capacity, sizeof(T) * capacity);
+        if (heap_data == nullptr)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        heap_data = (T *)allocator_alloc(&array->allocator, sizeof(T) * capacity);
+        if (heap_data == nullptr)
+        {
+            return false;
+        }
+        platform_memory_copy(heap_data, array->inline_data, sizeof(T) * array->size);
+    }
+
+    array->heap_data = heap_data;
+    array->heap_capacity = capacity;
+    return true;
+}
+
+/** New elements are left uninitialized. */
+template<typename T, s64 N>
+warpunk_api inline b8 smallarray_resize(smallarray<T, N>* array, s64 size)
+{
+    if (size > smallarray_capacity(array))
+    {
+        s64 capacity = smallarray_capacity(array) * 2;
+        if (!smallarray_reserve(array, (capacity < size) ? size : capacity))
+        {
+            return false;
+        }
+    }
+
+    array->size = size;
+    return true;
+}
+
+/** Amortized O(1), the first N adds never allocate. */
+template<typename T, s64 N>
+warpunk_api inline b8 smallarray_add(smallarray<T, N>* array, T element)
+{
+    if (!smallarray_resize(array, array->size + 1))
+    {
+        return false;
+    }
+
+    smallarray_data(array)[array->size - 1] = element;
+    return true;
+}
+
+template<typename T, s64 N>
+warpunk_api inline void smallarray_pop_back(smallarray<T, N>* array)
+{
+    if (array->size > 0)
+    {
+        array->size--;
+    }
+}
+
+/** Keeps the order of the remaining elements. */
+template<typename T, s64 N>
+warpunk_api inline void smallarray_remove_at(smallarray<T, N>* array, s64 index)
+{
+    if (index < 0 || index >= array->size)
+    {
+        return;
+    }
+
+    T* data = smallarray_data(array);
+    for (s64 element_idx = index; element_idx < array->size - 1; ++element_idx)
+    {
+        data[element_idx] = data[element_idx + 1];
+    }
+    array->size--;
+}
+
+/** Keeps the memory. */
+template<typename T, s64 N>
+warpunk_api inline void smallarray_clear(smallarray<T, N>* array)
+{
+    array->size = 0;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+#include <type_traits>
+
+/**
+ * @brief Lock free ring for exactly one producer and one consumer thread.
+ * `head` and `tail` only ever grow, the slot is the index masked by the power of two capacity.
+ * Each side keeps a cached copy of the other side's index and only reloads it when the ring looks full
+ * or empty, so in the common case the producer and consumer do not touch each other's cache line.
+ */
+template<typename T>
+struct spscqueue
+{
+    /** written by the consumer */
+    alignas(CACHE_LINE_SIZE) u64 head;
+    u64 cached_tail;
+
+    /** written by the producer */
+    alignas(CACHE_LINE_SIZE) u64 tail;
+    u64 cached_head;
+
+    alignas(CACHE_LINE_SIZE) T* data;
+    u64 mask;
+    allocator allocator;
+};
+
+/** `capacity` is rounded up to a power of two. The queue must not be moved while both threads use it. */
+template<typename T>
+warpunk_api inline b8 spscqueue_create(spscqueue<T>* out_queue, s64 capacity, allocator allocator = allocator_heap(MEMORY_TAG_CONTAINER))
+{
+    static_assert(std::is_trivially_copyable_v<T>, "queue elements are copied as raw memory");
+
+    u64 rounded_capacity = 1;
+    while (rounded_capacity < (u64)capacity)
+    {
+        rounded_capacity *= 2;
+    }
+
+    *out_queue = {};
+    out_queue->allocator = allocator;
+    out_queue->data = (T *)allocator_alloc(&out_queue->allocator, sizeof(T) * rounded_capacity);
+    if (out_queue->data == nullptr)
+    {
+        return false;
+    }
+    out_queue->mask = rounded_capacity - 1;
+    return true;
+}
+
+/** */
+template<typename T>
+warpunk_api inline void spscqueue_destroy(spscqueue<T>* queue)
+{
+    allocator_free(&queue->allocator, queue->data);
+    *queue = {};
+}
+
+/** Producer only. @returns the number of elements pushed, fewer than `count` if the queue filled up. */
+template<typename T>
+warpunk_api inline s64 spscqueue_push_batch(spscqueue<T>* queue, const T* elements, s64 count)
+{
+    u64 capacity = queue->mask + 1;
+    u64 tail = queue->tail;
+    if (tail + count - queue->cached_head > capacity)
+    {
+        queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    }
+
+    u64 free_count = capacity - (tail - queue->cached_head);
+    count = ((u64)count < free_count) ? count : (s64)free_count;
+    for (s64 element_idx = 0; element_idx < count; ++element_idx)
+    {
+        queue->data[(tail + element_idx) & queue->mask] = elements[element_idx];
+    }
+
+    __atomic_store_n(&queue->tail, tail + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+/** Producer only. @returns false if the queue is full. */
+template<typename T>
+warpunk_api inline b8 spscqueue_push(spscqueue<T>* queue, T element)
+{
+    return spscqueue_push_batch(queue, &element, 1) == 1;
+}
+
+/** Consumer only. @returns the number of elements written to `out_elements`, at most `max_count`. */
+template<typename T>
+warpunk_api inline s64 spscqueue_pop_batch(spscqueue<T>* queue, T* out_elements, s64 max_count)
+{
+    u64 head = queue->head;
+    if (queue->cached_tail - head < (u64)max_count)
+    {
+        queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    }
+
+    u64 available_count = queue->cached_tail - head;
+    s64 count = ((u64)max_count < available_count) ? max_count : (s64)available_count;
+    for (s64 element_idx = 0; element_idx < count; ++element_idx)
+    {
+        out_elements[element_idx] = queue->data[(head + element_idx) & queue->mask];
+    }
+
+    __atomic_store_n(&queue->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+/** Consumer only. @returns false if the queue is empty. */
+template<typename T>
+warpunk_api inline b8 spscqueue_pop(spscqueue<T>* queue, T* out_element)
+{
+    return spscqueue_pop_batch(queue, out_element, 1) == 1;
+}
+
+/** Exact on the consumer thread, a snapshot anywhere else. */
+template<typename T>
+warpunk_api inline s64 spscqueue_size(spscqueue<T>* queue)
+{
+    // head first, the tail read after it can only be further ahead
+    u64 head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    u64 tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    return (s64)(tail - head);
+}
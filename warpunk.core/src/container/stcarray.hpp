@@ -0,0 +1,89 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+
+#include <type_traits>
+
+/**
+ * @brief Array with a fixed capacity of N elements stored inline, it never allocates.
+ * Adding to a full array fails instead of growing.
+ */
+template<typename T, s64 N>
+struct stcarray
+{
+    s64 size;
+    T data[N];
+};
+
+template<typename T, s64 N>
+warpunk_api inline stcarray<T, N> stcarray_create()
+{
+    static_assert(std::is_trivially_copyable_v<T>, "stcarray elements are copied as raw memory");
+
+    stcarray<T, N> array;
+    array.size = 0;
+    return array;
+}
+
+template<typename T, s64 N>
+warpunk_api inline constexpr s64 stcarray_capacity(const stcarray<T, N>* array)
+{
+    return N;
+}
+
+/** @returns false if `size` is more than N. New elements are left uninitialized. */
+template<typename T, s64 N>
+warpunk_api inline b8 stcarray_resize(stcarray<T, N>* array, s64 size)
+{
+    if (size > N)
+    {
+        return false;
+    }
+
+    array->size = size;
+    return true;
+}
+
+/** @returns false if the array is full. */
+template<typename T, s64 N>
+warpunk_api inline b8 stcarray_add(stcarray<T, N>* array, T element)
+{
+    if (array->size == N)
+    {
+        return false;
+    }
+
+    array->data[array->size++] = element;
+    return true;
+}
+
+template<typename T, s64 N>
+warpunk_api inline void stcarray_pop_back(stcarray<T, N>* array)
+{
+    if (array->size > 0)
+    {
+        array->size--;
+    }
+}
+
+/** Keeps the order of the remaining elements. */
+template<typename T, s64 N>
+warpunk_api inline void stcarray_remove_at(stcarray<T, N>* array, s64 index)
+{
+    if (index < 0 || index >= array->size)
+    {
+        return;
+    }
+
+    for (s64 element_idx = index; element_idx < array->size - 1; ++element_idx)
+    {
+        array->data[element_idx] = array->data[element_idx + 1];
+    }
+    array->size--;
+}
+
+template<typename T, s64 N>
+warpunk_api inline void stcarray_clear(stcarray<T, N>* array)
+{
+    array->size = 0;
+}
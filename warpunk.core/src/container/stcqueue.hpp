@@ -2,6 +2,7 @@
 
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/memory_tracker.h"
 
 /** */
 template<typename T>
@@ -26,7 +27,7 @@ warpunk_api inline stcqueue<T> stcqueue_create(s64 size)
     stcqueue<T> queue = {};
     queue.size = size;
     queue.capacity = 0;
-    queue.data = (T *)platform_memory_alloc(sizeof(T) * size);
+    queue.data = (T *)WALLOC(sizeof(T) * size, MEMORY_TAG_CONTAINER);
     platform_memory_zero(queue.data, sizeof(T) * size);
     queue.head = 0;
     queue.tail = 0;
@@ -37,7 +38,7 @@ warpunk_api inline stcqueue<T> stcqueue_create(s64 size)
 template<typename T>
 warpunk_api inline void stcqueue_destroy(stcqueue<T>* queue)
 {   
-    platform_memory_free(queue->data);
+    WFREE(queue->data);
     queue->size = 0;
     queue->capacity = 0;
     queue->data = nullptr;
@@ -56,7 +57,7 @@ warpunk_api inline b8 stcqueue_enqueue(stcqueue<T>* queue, T element)
 
     queue->data[queue->tail] = element;
     queue->capacity++;
-    queue->tail = (queue->tail + 1) & queue->size;
+    queue->tail = (queue->tail + 1) % queue->size;
     return true;
 }
 
@@ -64,7 +65,8 @@ warpunk_api inline b8 stcqueue_enqueue(stcqueue<T>* queue, T element)
 template<typename T>
 warpunk_api inline T stcqueue_dequeue(stcqueue<T>* queue)
 {
-    if (queue->head == queue->tail)
+    // head == tail also when the queue is full
+    if (queue->capacity == 0)
     {
         return T {};
     }
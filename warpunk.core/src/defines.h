@@ -47,6 +47,9 @@ typedef double f64;
 #define MAX_F64 1.7976931348623158e+308
 #define MIN_F64 2.2250738585072014e-308
 
+/** padding between data written by different threads, keeps them off each other's cache lines */
+#define CACHE_LINE_SIZE 64
+
 typedef u32 camera_handle;
 
 #if defined(__linux__)
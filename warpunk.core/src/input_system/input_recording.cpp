@@ -0,0 +1,223 @@
+#include "warpunk.core/src/input_system/input_recording.h"
+
+#include "warpunk.core/src/input_system/input_system.h"
+#include "warpunk.core/src/utils/logger.h"
+
+#define INPUT_RECORDING_MAGIC 0x504E4957u /* "WINP" */
+#define INPUT_RECORDING_VERSION 1
+
+typedef struct input_recording_header
+{
+    u32 magic;
+    u32 version;
+    f64 fixed_delta_seconds;
+    /** both only known once the recorder closes, 0 in an unfinished recording */
+    u64 frame_count;
+    u64 event_count;
+} input_recording_header;
+
+static_assert(sizeof(input_recording_event) == 16, "the event layout is the file format");
+
+b8 input_recorder_open(input_recorder* recorder, const char* path, f64 fixed_delta_seconds)
+{
+    *recorder = {};
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file)
+    {
+        WERROR("Failed to open input recording %s for writing", path);
+        return false;
+    }
+
+    input_recording_header header = {
+        .magic = INPUT_RECORDING_MAGIC,
+        .version = INPUT_RECORDING_VERSION,
+        .fixed_delta_seconds = fixed_delta_seconds,
+    };
+    if (fwrite(&header, sizeof(header), 1, recorder->file) != 1)
+    {
+        WERROR("Failed to write input recording %s", path);
+        fclose(recorder->file);
+        recorder->file = nullptr;
+        return false;
+    }
+
+    recorder->fixed_delta_seconds = fixed_delta_seconds;
+    recorder->start_ticks = platform_get_ticks();
+    return true;
+}
+
+void input_recorder_record(input_recorder* recorder, u64 frame_index, const platform_event* event)
+{
+    if (!recorder->file)
+    {
+        return;
+    }
+
+    input_recording_event record = {
+        .frame_index = (u32)frame_index,
+        .time_us = (u32)(platform_ticks_to_ns(platform_get_ticks() - recorder->start_ticks) / 1000),
+        .type = (u8)event->type,
+    };
+    switch (event->type)
+    {
+        case PLATFORM_EVENT_TYPE_KEY:
+        {
+            record.code = (u16)event->key.keycode;
+            record.pressed = event->key.pressed;
+        } break;
+
+        case PLATFORM_EVENT_TYPE_MOUSE_BUTTON:
+        {
+            record.code = (u16)event->mouse_button.mouse_button;
+            record.pressed = event->mouse_button.pressed;
+        } break;
+
+        case PLATFORM_EVENT_TYPE_MOUSE_MOVE:
+        {
+            record.value = (s32)(((u32)(u16)event->mouse_move.y << 16) | (u16)event->mouse_move.x);
+        } break;
+
+        case PLATFORM_EVENT_TYPE_MOUSE_WHEEL:
+        {
+            record.value = event->mouse_wheel.delta;
+        } break;
+
+        default:
+        {
+            return;
+        }
+    }
+
+    /** stdio buffers the records, the file only sees a write every few kilobytes */
+    if (fwrite(&record, sizeof(record), 1, recorder->file) != 1)
+    {
+        WERROR("Failed to write input event, stopping the recording.");
+        fclose(recorder->file);
+        recorder->file = nullptr;
+        return;
+    }
+    recorder->event_count++;
+}
+
+b8 input_recorder_close(input_recorder* recorder, u64 frame_count)
+{
+    if (!recorder->file)
+    {
+        return false;
+    }
+
+    input_recording_header header = {
+        .magic = INPUT_RECORDING_MAGIC,
+        .version = INPUT_RECORDING_VERSION,
+        .fixed_delta_seconds = recorder->fixed_delta_seconds,
+        .frame_count = frame_count,
+        .event_count = recorder->event_count,
+    };
+    b8 result = fseek(recorder->file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, recorder->file) == 1;
+    if (fclose(recorder->file) != 0 || !result)
+    {
+        WERROR("Failed to finish the input recording.");
+        result = false;
+    }
+    else
+    {
+        WINFO("Recorded %llu input events over %llu frames.", (unsigned long long)recorder->event_count, (unsigned long long)frame_count);
+    }
+
+    recorder->file = nullptr;
+    return result;
+}
+
+b8 input_player_open(input_player* player, const char* path)
+{
+    *player = {};
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        WERROR("Failed to open input recording %s", path);
+        return false;
+    }
+
+    input_recording_header header = {};
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION ||
+        header.frame_count == 0)
+    {
+        WERROR("%s is not a finished version %d input recording", path, INPUT_RECORDING_VERSION);
+        fclose(file);
+        return false;
+    }
+
+    player->events = dynarray_create<input_recording_event>(header.event_count, allocator_heap(MEMORY_TAG_APPLICATION));
+    b8 result = header.event_count == 0 ||
+                (player->events.data != nullptr &&
+                 fread(player->events.data, sizeof(input_recording_event), header.event_count, file) == header.event_count);
+    fclose(file);
+
+    /** the codes index the input system's state arrays, a corrupt file must not write past them */
+    for (u64 event_idx = 0; result && event_idx < header.event_count; ++event_idx)
+    {
+        const input_recording_event* record = &player->events.data[event_idx];
+        result = record->type <= PLATFORM_EVENT_TYPE_MOUSE_WHEEL &&
+                 (record->type != PLATFORM_EVENT_TYPE_KEY || record->code < KEYCODE_COUNT) &&
+                 (record->type != PLATFORM_EVENT_TYPE_MOUSE_BUTTON || record->code < MOUSE_BUTTON_COUNT);
+    }
+
+    if (!result)
+    {
+        WERROR("Input recording %s is truncated or corrupt", path);
+        dynarray_destroy(&player->events);
+        return false;
+    }
+
+    player->fixed_delta_seconds = header.fixed_delta_seconds;
+    player->frame_count = header.frame_count;
+    return true;
+}
+
+b8 input_player_play_frame(input_player* player, u64 frame_index)
+{
+    if (frame_index >= player->frame_count)
+    {
+        return false;
+    }
+
+    for (; player->next_event_idx < player->events.size; ++player->next_event_idx)
+    {
+        const input_recording_event* record = &player->events.data[player->next_event_idx];
+        if (record->frame_index > frame_index)
+        {
+            break;
+        }
+
+        switch (record->type)
+        {
+            case PLATFORM_EVENT_TYPE_KEY:
+            {
+                input_system_process_key((keycode)record->code, record->pressed);
+            } break;
+
+            case PLATFORM_EVENT_TYPE_MOUSE_BUTTON:
+            {
+                input_system_process_mouse_button((mouse_button)record->code, record->pressed);
+            } break;
+
+            case PLATFORM_EVENT_TYPE_MOUSE_MOVE:
+            {
+                input_system_process_mouse_move((s16)(record->value & 0xFFFF), (s16)((u32)record->value >> 16));
+            } break;
+
+            case PLATFORM_EVENT_TYPE_MOUSE_WHEEL:
+            {
+                input_system_process_mouse_wheel(record->value);
+            } break;
+        }
+    }
+    return true;
+}
+
+void input_player_close(input_player* player)
+{
+    dynarray_destroy(&player->events);
+    *player = {};
+}
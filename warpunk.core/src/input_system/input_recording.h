@@ -0,0 +1,63 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/container/dynarray.hpp"
+#include "warpunk.core/src/platform/platform.h"
+
+#include <stdio.h>
+
+/** @brief One input event as stored in a recording, 16 bytes little endian. */
+typedef struct input_recording_event
+{
+    /** frame the event arrived in, the player applies it at the start of the same frame */
+    u32 frame_index;
+    /** microseconds since the recording started, the player only goes by the frame index */
+    u32 time_us;
+    /** platform_event_type, window state events are not recorded */
+    u8 type;
+    u8 pressed;
+    /** keycode or mouse_button */
+    u16 code;
+    /** wheel delta, or x in the low and y in the high 16 bits of a move */
+    s32 value;
+} input_recording_event;
+
+typedef struct input_recorder
+{
+    FILE* file;
+    /** the timestep the session runs at, the player has to use the same one */
+    f64 fixed_delta_seconds;
+    u64 start_ticks;
+    u64 event_count;
+} input_recorder;
+
+typedef struct input_player
+{
+    dynarray<input_recording_event> events;
+    f64 fixed_delta_seconds;
+    /** frames the recorded session ran */
+    u64 frame_count;
+    s64 next_event_idx;
+} input_player;
+
+/** Creates `path` and writes the header, the events are streamed as they are recorded. */
+no_mangle warpunk_api b8 input_recorder_open(input_recorder* recorder, const char* path, f64 fixed_delta_seconds);
+
+/** Appends a key, mouse button, mouse move or mouse wheel event that arrived during `frame_index`. */
+no_mangle warpunk_api void input_recorder_record(input_recorder* recorder, u64 frame_index, const platform_event* event);
+
+/** Stores the session length in the header, `frame_count` frames ran while recording. */
+no_mangle warpunk_api b8 input_recorder_close(input_recorder* recorder, u64 frame_count);
+
+/** Reads the whole recording, a minute of input is a few hundred kilobytes at most. */
+no_mangle warpunk_api b8 input_player_open(input_player* player, const char* path);
+
+/**
+ * Feeds the events recorded up to `frame_index` through input_system_process_*, called once per frame
+ * before the update. Events are applied in the order they were recorded.
+ * @returns false once `frame_index` is past the recorded session.
+ */
+no_mangle warpunk_api b8 input_player_play_frame(input_player* player, u64 frame_index);
+
+/** */
+no_mangle warpunk_api void input_player_close(input_player* player);
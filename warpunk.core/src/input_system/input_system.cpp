@@ -3,6 +3,7 @@
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/input_system/input_types.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/profiler.h"
 
 //////////////////////////////////////////////////////////////////////
 
@@ -83,6 +84,8 @@ void input_system_shutdown()
 
 void input_system_update()
 {
+    WPROFILE_FUNCTION();
+
     // KEYBOARD
     keyboard* keyboard = &input_state.keyboard; 
     for (u32 key_index = 0; key_index < KEYCODE_COUNT; ++key_index)
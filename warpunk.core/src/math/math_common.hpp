@@ -101,55 +101,98 @@ template<typename T>
 }
 
 // random
-static std::random_device random_device;
-static std::mt19937 gen(random_device()); 
+
+/** 
+ * splitmix64, a 64 bit state generator that is cheap enough to be reseeded for every sample. 
+ * Satisfies UniformRandomBitGenerator so it also drives the std distributions.
+ */
+struct random_engine
+{
+    using result_type = u64;
+
+    u64 state;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~(result_type)0; }
+
+    result_type operator()()
+    {
+        u64 z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
 
 /** */
-template<typename T, std::enable_if_t<std::is_same_v<T, s16> || std::is_same_v<T, s32> || std::is_same_v<T, s64>, int> = 0>
-[[nodiscard]] inline T randint()
+[[nodiscard]] inline u64 random_device_seed()
 {
-    std::uniform_int_distribution<T> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
-    return distribution(gen);
+    std::random_device random_device;
+    return ((u64)random_device() << 32) ^ random_device();
 }
 
-/** */
-template<typename T, std::enable_if_t<std::is_same_v<T, s16> || std::is_same_v<T, s32> || std::is_same_v<T, s64>, int> = 0>
-[[nodiscard]] inline T randint(T low, T high)
+/** every thread owns its generator, seeded from the random device on first use */
+inline thread_local random_engine gen = { random_device_seed() };
+
+/** Mixes two values into a well distributed seed, used to derive per pixel/sample streams. */
+[[nodiscard]] inline u64 random_hash(u64 a, u64 b)
 {
-    std::uniform_int_distribution<T> distribution(low, high);
-    return distribution(gen);
+    random_engine engine = { a ^ (b * 0xD1B54A32D192ED03ull) };
+    return engine();
+}
+
+/** Restarts the calling thread's random stream. */
+inline void random_seed(u64 seed)
+{
+    gen.state = seed;
 }
 
 /** */
-template<typename T, std::enable_if_t<std::is_same_v<T, f32> || std::is_same_v<T, f64>, int> = 0>
-[[nodiscard]] inline T randreal()
+template<typename T, std::enable_if_t<std::is_same_v<T, s16> || std::is_same_v<T, s32> || std::is_same_v<T, s64>, int> = 0>
+[[nodiscard]] inline T randint()
 {
-    std::uniform_real_distribution<T> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+    std::uniform_int_distribution<T> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
     return distribution(gen);
 }
 
 /** */
-template<typename T, std::enable_if_t<std::is_same_v<T, f32> || std::is_same_v<T, f64>, int> = 0>
-[[nodiscard]] inline T randreal(T low, T high)
+template<typename T, std::enable_if_t<std::is_same_v<T, s16> || std::is_same_v<T, s32> || std::is_same_v<T, s64>, int> = 0>
+[[nodiscard]] inline T randint(T low, T high)
 {
-    std::uniform_real_distribution<T> distribution(low, high);
+    std::uniform_int_distribution<T> distribution(low, high);
     return distribution(gen);
 }
 
 template<typename T>
 [[nodiscard]] inline T randreal01() = delete;
 
+/** 
+ * the uniform reals are built from the raw bits instead of std::uniform_real_distribution, 
+ * so a seeded stream produces the same values with every standard library 
+ */
 template<>
 [[nodiscard]] inline f32 randreal01()
 {
-    std::uniform_real_distribution<f32> distribution(0.0f, 1.0f);
-    return distribution(gen);
+    return (f32)(gen() >> 40) * 0x1.0p-24f;
 }
 
 template<>
 [[nodiscard]] inline f64 randreal01()
 {
-    std::uniform_real_distribution<f64> distribution(0.0, 1.0);
+    return (f64)(gen() >> 11) * 0x1.0p-53;
+}
+
+/** */
+template<typename T, std::enable_if_t<std::is_same_v<T, f32> || std::is_same_v<T, f64>, int> = 0>
+[[nodiscard]] inline T randreal()
+{
+    std::uniform_real_distribution<T> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
     return distribution(gen);
 }
 
+/** */
+template<typename T, std::enable_if_t<std::is_same_v<T, f32> || std::is_same_v<T, f64>, int> = 0>
+[[nodiscard]] inline T randreal(T low, T high)
+{
+    return low + (high - low) * randreal01<T>();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/memory_tracker.h"
+
+typedef void* (*allocator_alloc_t)(void* context, s64 size);
+typedef void (*allocator_free_t)(void* context, void* memory);
+typedef void* (*allocator_realloc_t)(void* context, void* memory, s64 old_size, s64 size);
+
+/** 
+ * @brief Where a container gets its memory from. 
+ * Without `alloc` the allocator is the tracked heap, so a zero initialized one keeps working.
+ */
+typedef struct allocator
+{
+    allocator_alloc_t alloc;
+    /** nullptr if the memory is released in bulk, e.g. by resetting an arena */
+    allocator_free_t free;
+    /** nullptr falls back to alloc, copy and free */
+    allocator_realloc_t realloc;
+    void* context;
+    /** tag of the heap allocations, unused with `alloc` */
+    memory_tag tag;
+} allocator;
+
+/** */
+inline allocator allocator_heap(memory_tag tag)
+{
+    allocator allocator = {};
+    allocator.tag = tag;
+    return allocator;
+}
+
+/** Every allocation is at least 16 byte aligned, like platform_memory_alloc. */
+inline void* allocator_alloc(const allocator* allocator, s64 size)
+{
+    if (allocator->alloc == nullptr)
+    {
+        return WALLOC(size, allocator->tag);
+    }
+    return allocator->alloc(allocator->context, size);
+}
+
+/** Keeps the first min(old_size, size) bytes, the old block is released unless nullptr is returned. */
+inline void* allocator_realloc(const allocator* allocator, void* memory, s64 old_size, s64 size)
+{
+    if (memory == nullptr)
+    {
+        return allocator_alloc(allocator, size);
+    }
+    if (allocator->alloc == nullptr)
+    {
+        return WREALLOC(memory, size);
+    }
+    if (allocator->realloc != nullptr)
+    {
+        return allocator->realloc(allocator->context, memory, old_size, size);
+    }
+
+    void* result = allocator->alloc(allocator->context, size);
+    if (result == nullptr)
+    {
+        return nullptr;
+    }
+    platform_memory_copy(result, memory, (old_size < size) ? old_size : size);
+    if (allocator->free != nullptr)
+    {
+        allocator->free(allocator->context, memory);
+    }
+    return result;
+}
+
+/** */
+inline void allocator_free(const allocator* allocator, void* memory)
+{
+    if (allocator->alloc == nullptr)
+    {
+        WFREE(memory);
+    }
+    else if (allocator->free != nullptr)
+    {
+        allocator->free(allocator->context, memory);
+    }
+}
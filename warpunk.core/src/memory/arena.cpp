@@ -0,0 +1,91 @@
+#include "warpunk.core/src/memory/arena.h"
+
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/logger.h"
+
+b8 arena_create(arena* out_arena, s64 capacity, memory_tag tag)
+{
+    capacity = (capacity + ARENA_ALIGNMENT - 1) & ~(s64)(ARENA_ALIGNMENT - 1);
+    out_arena->memory = (u8 *)WALLOC(capacity, tag);
+    if (out_arena->memory == nullptr)
+    {
+        WERROR("Failed to allocate an arena of %lld bytes", (long long)capacity);
+        *out_arena = {};
+        return false;
+    }
+
+    out_arena->capacity = capacity;
+    out_arena->offset = 0;
+    out_arena->peak = 0;
+    return true;
+}
+
+void arena_destroy(arena* arena)
+{
+    WFREE(arena->memory);
+    *arena = {};
+}
+
+void* arena_alloc(arena* arena, s64 size)
+{
+    s64 aligned_size = (size + ARENA_ALIGNMENT - 1) & ~(s64)(ARENA_ALIGNMENT - 1);
+    if (arena->offset + aligned_size > arena->capacity)
+    {
+        return nullptr;
+    }
+
+    void* memory = arena->memory + arena->offset;
+    arena->offset += aligned_size;
+    arena->peak = (arena->offset > arena->peak) ? arena->offset : arena->peak;
+    return memory;
+}
+
+void arena_reset(arena* arena)
+{
+    arena->offset = 0;
+}
+
+arena_marker arena_mark(arena* arena)
+{
+    return arena_marker { arena, arena->offset };
+}
+
+void arena_rewind(arena_marker marker)
+{
+    marker.arena->offset = marker.offset;
+}
+
+static void* arena_allocator_alloc(void* context, s64 size)
+{
+    return arena_alloc((arena *)context, size);
+}
+
+/** the most recent allocation grows in place, anything else is copied to the top of the arena */
+static void* arena_allocator_realloc(void* context, void* memory, s64 old_size, s64 size)
+{
+    arena* arena = (struct arena *)context;
+    s64 aligned_old_size = (old_size + ARENA_ALIGNMENT - 1) & ~(s64)(ARENA_ALIGNMENT - 1);
+    if ((u8 *)memory + aligned_old_size == arena->memory + arena->offset)
+    {
+        arena_marker marker = { arena, arena->offset - aligned_old_size };
+        arena_rewind(marker);
+        if (arena_alloc(arena, size) == nullptr)
+        {
+            arena->offset = marker.offset + aligned_old_size;
+            return nullptr;
+        }
+        return memory;
+    }
+
+    void* result = arena_alloc(arena, size);
+    if (result != nullptr)
+    {
+        platform_memory_copy(result, memory, (old_size < size) ? old_size : size);
+    }
+    return result;
+}
+
+allocator arena_allocator(arena* arena)
+{
+    return allocator { .alloc = arena_allocator_alloc, .free = nullptr, .realloc = arena_allocator_realloc, .context = arena };
+}
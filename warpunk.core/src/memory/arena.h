@@ -0,0 +1,44 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+#define ARENA_ALIGNMENT 16
+
+/** @brief Linear allocator over one fixed block, allocations are only released all at once. */
+typedef struct arena
+{
+    u8* memory;
+    s64 capacity;
+    s64 offset;
+    /** highest offset since creation, used to size the arena */
+    s64 peak;
+} arena;
+
+/** @brief Offset to roll an arena back to, releases everything allocated after it was taken. */
+typedef struct arena_marker
+{
+    arena* arena;
+    s64 offset;
+} arena_marker;
+
+/** The backing block is counted under `tag`. */
+no_mangle warpunk_api b8 arena_create(arena* out_arena, s64 capacity, memory_tag tag);
+
+/** */
+no_mangle warpunk_api void arena_destroy(arena* arena);
+
+/** @returns ARENA_ALIGNMENT aligned memory, nullptr if the arena is full. The memory is not zeroed. */
+no_mangle warpunk_api void* arena_alloc(arena* arena, s64 size);
+
+/** Releases every allocation in O(1). */
+no_mangle warpunk_api void arena_reset(arena* arena);
+
+/** */
+no_mangle warpunk_api arena_marker arena_mark(arena* arena);
+
+/** */
+no_mangle warpunk_api void arena_rewind(arena_marker marker);
+
+/** @returns an allocator that allocates from `arena`, freeing through it is a no-op. */
+no_mangle warpunk_api allocator arena_allocator(arena* arena);
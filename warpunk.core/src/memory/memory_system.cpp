@@ -0,0 +1,127 @@
+#include "warpunk.core/src/memory/memory_system.h"
+
+#include "warpunk.core/src/utils/logger.h"
+
+#define MEMORY_SYSTEM_DEFAULT_FRAME_ARENA_SIZE (4 * 1024 * 1024)
+#define MEMORY_SYSTEM_DEFAULT_SCRATCH_ARENA_SIZE (256 * 1024)
+/** one frame is prepared while the one before renders */
+#define MEMORY_SYSTEM_FRAME_ARENA_COUNT 2
+
+typedef struct memory_system_state
+{
+    b8 is_initialized;
+    memory_system_config config;
+    arena frame_arenas[MEMORY_SYSTEM_FRAME_ARENA_COUNT];
+    /** the arena of the current frame, the other one holds the frame that may still be rendering */
+    s32 frame_arena_idx;
+} memory_system_state;
+
+/** owns the scratch arena of one thread and frees it when the thread exits */
+typedef struct scratch_state
+{
+    arena arena;
+
+    ~scratch_state()
+    {
+        if (arena.memory)
+        {
+            arena_destroy(&arena);
+        }
+    }
+} scratch_state;
+
+static memory_system_state state;
+static thread_local scratch_state scratch;
+
+b8 memory_system_startup(memory_system_config memory_system_config)
+{
+    if (memory_system_config.frame_arena_size <= 0)
+    {
+        memory_system_config.frame_arena_size = MEMORY_SYSTEM_DEFAULT_FRAME_ARENA_SIZE;
+    }
+    if (memory_system_config.scratch_arena_size <= 0)
+    {
+        memory_system_config.scratch_arena_size = MEMORY_SYSTEM_DEFAULT_SCRATCH_ARENA_SIZE;
+    }
+
+    state.config = memory_system_config;
+    memory_tracker_trace_enable(memory_system_config.trace_allocations);
+    for (s32 arena_idx = 0; arena_idx < MEMORY_SYSTEM_FRAME_ARENA_COUNT; ++arena_idx)
+    {
+        if (!arena_create(&state.frame_arenas[arena_idx], memory_system_config.frame_arena_size, MEMORY_TAG_ARENA))
+        {
+            for (s32 created_idx = 0; created_idx < arena_idx; ++created_idx)
+            {
+                arena_destroy(&state.frame_arenas[created_idx]);
+            }
+            return false;
+        }
+    }
+    state.frame_arena_idx = 0;
+
+    state.is_initialized = true;
+    return true;
+}
+
+void memory_system_shutdown()
+{
+    for (s32 arena_idx = 0; arena_idx < MEMORY_SYSTEM_FRAME_ARENA_COUNT; ++arena_idx)
+    {
+        arena* frame_arena = &state.frame_arenas[arena_idx];
+        if (frame_arena->peak > 0)
+        {
+            WDEBUG("Frame arena %d peak: %lld of %lld bytes", arena_idx, (long long)frame_arena->peak, (long long)frame_arena->capacity);
+        }
+        arena_destroy(frame_arena);
+    }
+    state.is_initialized = false;
+
+    memory_tracker_log_usage();
+    if (state.config.trace_allocations)
+    {
+        memory_tracker_trace_dump();
+    }
+}
+
+// FRAME
+
+void* memory_system_frame_alloc(s64 size)
+{
+    arena* frame_arena = &state.frame_arenas[state.frame_arena_idx];
+    void* memory = arena_alloc(frame_arena, size);
+    if (memory == nullptr)
+    {
+        WERROR("Frame arena exhausted, %lld bytes requested with %lld of %lld in use", 
+                (long long)size, (long long)frame_arena->offset, (long long)frame_arena->capacity);
+    }
+    return memory;
+}
+
+allocator memory_system_frame_allocator()
+{
+    return arena_allocator(&state.frame_arenas[state.frame_arena_idx]);
+}
+
+void memory_system_frame_reset()
+{
+    state.frame_arena_idx = (state.frame_arena_idx + 1) % MEMORY_SYSTEM_FRAME_ARENA_COUNT;
+    arena_reset(&state.frame_arenas[state.frame_arena_idx]);
+    memory_tracker_frame_end();
+}
+
+// SCRATCH
+
+arena_marker memory_system_scratch_begin()
+{
+    if (scratch.arena.memory == nullptr)
+    {
+        s64 size = state.is_initialized ? state.config.scratch_arena_size : MEMORY_SYSTEM_DEFAULT_SCRATCH_ARENA_SIZE;
+        arena_create(&scratch.arena, size, MEMORY_TAG_ARENA);
+    }
+    return arena_mark(&scratch.arena);
+}
+
+void memory_system_scratch_end(arena_marker marker)
+{
+    arena_rewind(marker);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/memory/allocator.h"
+#include "warpunk.core/src/memory/arena.h"
+#include "warpunk.core/src/memory/memory_tracker.h"
+
+typedef struct memory_system_config
+{
+    /** bytes the main thread can allocate per frame, reserved once per frame in flight */
+    s64 frame_arena_size;
+    /** bytes of temporaries every thread can hold between scratch begin and end */
+    s64 scratch_arena_size;
+    /** attribute every allocation to its call site, dumped at shutdown */
+    b8 trace_allocations;
+} memory_system_config;
+
+/** */
+no_mangle warpunk_api b8 memory_system_startup(memory_system_config memory_system_config);
+
+/** */
+no_mangle warpunk_api void memory_system_shutdown();
+
+// FRAME
+
+/** 
+ * Memory that lives until the end of the next frame, the render thread still reads the previous frame's
+ * packet while the main thread prepares the current one.
+ * NOTE: the frame arena is not synchronized, only the main thread may allocate from it.
+ */
+no_mangle warpunk_api void* memory_system_frame_alloc(s64 size);
+
+/** Allocates from the current frame's arena, like memory_system_frame_alloc. */
+no_mangle warpunk_api allocator memory_system_frame_allocator();
+
+/** 
+ * Starts the next frame on the arena of the frame before the current one, releases its allocations in O(1)
+ * and closes the per frame allocation counters. Called by the engine at the end of every frame, once the
+ * render thread is done with the frame before.
+ */
+no_mangle warpunk_api void memory_system_frame_reset();
+
+// SCRATCH
+
+/** 
+ * Starts a scope of temporaries on the calling thread's scratch arena, allocate them from `marker.arena`.
+ * The arena is created on the thread's first use. Scopes nest, every begin has to be matched by memory_system_scratch_end with the returned marker.
+ */
+no_mangle warpunk_api arena_marker memory_system_scratch_begin();
+
+/** Releases everything allocated from the scratch arena since `marker` was taken. */
+no_mangle warpunk_api void memory_system_scratch_end(arena_marker marker);
@@ -0,0 +1,329 @@
+#include "warpunk.core/src/memory/memory_tracker.h"
+
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/logger.h"
+
+#include <stdlib.h>
+
+#define MEMORY_TRACKER_SITE_COUNT 1024
+#define MEMORY_TRACKER_NO_SITE 0xFFFF
+/** sites printed by memory_tracker_trace_dump */
+#define MEMORY_TRACKER_DUMP_SITE_COUNT 32
+
+/** sits right in front of every tracked block, its size keeps the block 16 byte aligned */
+typedef struct alignas(16) memory_header
+{
+    s64 size;
+    const char* file;
+    s32 line;
+    u16 tag;
+    /** index into the site table, MEMORY_TRACKER_NO_SITE if the block was not traced */
+    u16 site_idx;
+} memory_header;
+
+typedef struct memory_site
+{
+    const char* file;
+    s32 line;
+    memory_tag tag;
+    s64 alloc_count;
+    s64 alloc_bytes;
+    s64 live_count;
+    s64 live_bytes;
+} memory_site;
+
+typedef struct memory_tag_counters
+{
+    s64 live_bytes;
+    s64 live_count;
+    s64 peak_bytes;
+    s64 total_alloc_count;
+    s64 budget_bytes;
+    b8 budget_warned;
+
+    s64 frame_alloc_count;
+    s64 frame_alloc_bytes;
+    s64 last_frame_alloc_count;
+    s64 last_frame_alloc_bytes;
+} memory_tag_counters;
+
+typedef struct memory_tracker_state
+{
+    /** updated with relaxed atomics, the allocating threads never wait on each other */
+    memory_tag_counters counters[MEMORY_TAG_COUNT];
+
+    b8 is_tracing;
+    /** spin lock around the site table, only taken while tracing */
+    b8 site_lock;
+    s64 dropped_site_count;
+    memory_site sites[MEMORY_TRACKER_SITE_COUNT];
+} memory_tracker_state;
+
+static memory_tracker_state state;
+
+static const char* memory_tag_names[MEMORY_TAG_COUNT] = {
+    "unknown",
+    "platform",
+    "threading",
+    "container",
+    "arena",
+    "renderer",
+    "scene",
+    "logging",
+    "profiler",
+    "application",
+};
+
+static void memory_tracker_site_lock()
+{
+    while (__atomic_test_and_set(&state.site_lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void memory_tracker_site_unlock()
+{
+    __atomic_clear(&state.site_lock, __ATOMIC_RELEASE);
+}
+
+/** @returns the site of file:line, creating it on first use, MEMORY_TRACKER_NO_SITE if the table is full */
+static u16 memory_tracker_site_find(const char* file, s32 line, memory_tag tag)
+{
+    u64 hash = ((u64)(uintptr_t)file * 0x9E3779B97F4A7C15ull) ^ (u64)line;
+    for (s32 probe = 0; probe < MEMORY_TRACKER_SITE_COUNT; ++probe)
+    {
+        u16 site_idx = (u16)((hash + probe) & (MEMORY_TRACKER_SITE_COUNT - 1));
+        memory_site* site = &state.sites[site_idx];
+        if (site->file == file && site->line == line)
+        {
+            return site_idx;
+        }
+        if (site->file == nullptr)
+        {
+            site->file = file;
+            site->line = line;
+            site->tag = tag;
+            return site_idx;
+        }
+    }
+
+    state.dropped_site_count++;
+    return MEMORY_TRACKER_NO_SITE;
+}
+
+static void memory_tracker_count_alloc(memory_header* header)
+{
+    memory_tag_counters* counters = &state.counters[header->tag];
+    s64 live_bytes = __atomic_add_fetch(&counters->live_bytes, header->size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counters->live_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counters->total_alloc_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counters->frame_alloc_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counters->frame_alloc_bytes, header->size, __ATOMIC_RELAXED);
+
+    s64 peak_bytes = __atomic_load_n(&counters->peak_bytes, __ATOMIC_RELAXED);
+    while (live_bytes > peak_bytes &&
+           !__atomic_compare_exchange_n(&counters->peak_bytes, &peak_bytes, live_bytes, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+
+    s64 budget_bytes = __atomic_load_n(&counters->budget_bytes, __ATOMIC_RELAXED);
+    if (budget_bytes > 0 && live_bytes > budget_bytes && !__atomic_exchange_n(&counters->budget_warned, true, __ATOMIC_RELAXED))
+    {
+        WWARNING("Memory tag %s exceeded its budget: %lld of %lld bytes live (%s:%d)",
+                memory_tag_names[header->tag], (long long)live_bytes, (long long)budget_bytes, header->file, header->line);
+    }
+
+    header->site_idx = MEMORY_TRACKER_NO_SITE;
+    if (__atomic_load_n(&state.is_tracing, __ATOMIC_RELAXED))
+    {
+        memory_tracker_site_lock();
+        header->site_idx = memory_tracker_site_find(header->file, header->line, (memory_tag)header->tag);
+        if (header->site_idx != MEMORY_TRACKER_NO_SITE)
+        {
+            memory_site* site = &state.sites[header->site_idx];
+            site->alloc_count++;
+            site->alloc_bytes += header->size;
+            site->live_count++;
+            site->live_bytes += header->size;
+        }
+        memory_tracker_site_unlock();
+    }
+}
+
+static void memory_tracker_count_free(memory_header* header)
+{
+    memory_tag_counters* counters = &state.counters[header->tag];
+    __atomic_sub_fetch(&counters->live_bytes, header->size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&counters->live_count, 1, __ATOMIC_RELAXED);
+
+    if (header->site_idx != MEMORY_TRACKER_NO_SITE)
+    {
+        memory_tracker_site_lock();
+        memory_site* site = &state.sites[header->site_idx];
+        site->live_count--;
+        site->live_bytes -= header->size;
+        memory_tracker_site_unlock();
+    }
+}
+
+void* memory_tracker_alloc(s64 size, memory_tag tag, const char* file, s32 line)
+{
+    memory_header* header = (memory_header *)platform_memory_alloc(sizeof(memory_header) + size);
+    if (header == nullptr)
+    {
+        WERROR("Failed to allocate %lld bytes for %s at %s:%d", (long long)size, memory_tag_names[tag], file, line);
+        return nullptr;
+    }
+
+    header->size = size;
+    header->file = file;
+    header->line = line;
+    header->tag = (u16)tag;
+    memory_tracker_count_alloc(header);
+    return header + 1;
+}
+
+void memory_tracker_free(void* memory)
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    memory_header* header = (memory_header *)memory - 1;
+    memory_tracker_count_free(header);
+    platform_memory_free(header);
+}
+
+void* memory_tracker_realloc(void* memory, s64 size, const char* file, s32 line)
+{
+    if (memory == nullptr)
+    {
+        return memory_tracker_alloc(size, MEMORY_TAG_UNKNOWN, file, line);
+    }
+    if (size == 0)
+    {
+        memory_tracker_free(memory);
+        return nullptr;
+    }
+
+    memory_header old_header = *((memory_header *)memory - 1);
+    memory_header* result = (memory_header *)platform_memory_realloc((memory_header *)memory - 1, sizeof(memory_header) + size);
+    if (result == nullptr)
+    {
+        WERROR("Failed to reallocate %lld bytes for %s at %s:%d", (long long)size, memory_tag_names[old_header.tag], file, line);
+        return nullptr;
+    }
+
+    memory_tracker_count_free(&old_header);
+    result->size = size;
+    result->file = file;
+    result->line = line;
+    memory_tracker_count_alloc(result);
+    return result + 1;
+}
+
+s64 memory_tracker_size(const void* memory)
+{
+    return ((const memory_header *)memory - 1)->size;
+}
+
+void memory_tracker_frame_end()
+{
+    for (s32 tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        memory_tag_counters* counters = &state.counters[tag];
+        counters->last_frame_alloc_count = __atomic_exchange_n(&counters->frame_alloc_count, 0, __ATOMIC_RELAXED);
+        counters->last_frame_alloc_bytes = __atomic_exchange_n(&counters->frame_alloc_bytes, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void memory_tracker_get_stats(memory_tag tag, memory_tag_stats* out_stats)
+{
+    memory_tag_counters* counters = &state.counters[tag];
+    out_stats->live_bytes = __atomic_load_n(&counters->live_bytes, __ATOMIC_RELAXED);
+    out_stats->live_count = __atomic_load_n(&counters->live_count, __ATOMIC_RELAXED);
+    out_stats->peak_bytes = __atomic_load_n(&counters->peak_bytes, __ATOMIC_RELAXED);
+    out_stats->total_alloc_count = __atomic_load_n(&counters->total_alloc_count, __ATOMIC_RELAXED);
+    out_stats->frame_alloc_count = counters->last_frame_alloc_count;
+    out_stats->frame_alloc_bytes = counters->last_frame_alloc_bytes;
+}
+
+s64 memory_tracker_total_alloc_count()
+{
+    s64 total_alloc_count = 0;
+    for (s32 tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        total_alloc_count += __atomic_load_n(&state.counters[tag].total_alloc_count, __ATOMIC_RELAXED);
+    }
+    return total_alloc_count;
+}
+
+void memory_tracker_set_budget(memory_tag tag, s64 budget_bytes)
+{
+    __atomic_store_n(&state.counters[tag].budget_bytes, budget_bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&state.counters[tag].budget_warned, false, __ATOMIC_RELAXED);
+}
+
+void memory_tracker_log_usage()
+{
+    WINFO("Memory usage:");
+    for (s32 tag = 0; tag < MEMORY_TAG_COUNT; ++tag)
+    {
+        memory_tag_stats stats;
+        memory_tracker_get_stats((memory_tag)tag, &stats);
+        if (stats.total_alloc_count == 0)
+        {
+            continue;
+        }
+
+        WINFO("  %-12s live %10lld B in %6lld blocks, peak %10lld B, last frame %lld allocs / %lld B",
+                memory_tag_names[tag], (long long)stats.live_bytes, (long long)stats.live_count,
+                (long long)stats.peak_bytes, (long long)stats.frame_alloc_count, (long long)stats.frame_alloc_bytes);
+    }
+}
+
+void memory_tracker_trace_enable(b8 enable)
+{
+    __atomic_store_n(&state.is_tracing, enable, __ATOMIC_RELAXED);
+}
+
+static int memory_tracker_site_compare(const void* a, const void* b)
+{
+    const memory_site* site_a = (const memory_site *)a;
+    const memory_site* site_b = (const memory_site *)b;
+    if (site_a->alloc_count != site_b->alloc_count)
+    {
+        return (site_a->alloc_count < site_b->alloc_count) ? 1 : -1;
+    }
+    return 0;
+}
+
+void memory_tracker_trace_dump()
+{
+    static memory_site sites[MEMORY_TRACKER_SITE_COUNT];
+    memory_tracker_site_lock();
+    platform_memory_copy(sites, state.sites, sizeof(sites));
+    s64 dropped_site_count = state.dropped_site_count;
+    memory_tracker_site_unlock();
+
+    qsort(sites, MEMORY_TRACKER_SITE_COUNT, sizeof(memory_site), memory_tracker_site_compare);
+
+    WINFO("Allocation sites:");
+    for (s32 site_idx = 0; site_idx < MEMORY_TRACKER_DUMP_SITE_COUNT && sites[site_idx].file; ++site_idx)
+    {
+        memory_site* site = &sites[site_idx];
+        WINFO("  %6lld allocs %10lld B, live %4lld / %10lld B  %-10s %s:%d",
+                (long long)site->alloc_count, (long long)site->alloc_bytes, (long long)site->live_count,
+                (long long)site->live_bytes, memory_tag_names[site->tag], site->file, site->line);
+    }
+    if (dropped_site_count > 0)
+    {
+        WWARNING("  %lld allocations were not attributed, the site table is full", (long long)dropped_site_count);
+    }
+}
+
+const char* memory_tag_name(memory_tag tag)
+{
+    return (tag >= 0 && tag < MEMORY_TAG_COUNT) ? memory_tag_names[tag] : "invalid";
+}
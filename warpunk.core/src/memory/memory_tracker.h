@@ -0,0 +1,78 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+
+typedef enum memory_tag
+{
+    MEMORY_TAG_UNKNOWN,
+    MEMORY_TAG_PLATFORM,
+    MEMORY_TAG_THREADING,
+    MEMORY_TAG_CONTAINER,
+    /** backing blocks of arenas and pools, their contents are not tracked individually */
+    MEMORY_TAG_ARENA,
+    MEMORY_TAG_RENDERER,
+    MEMORY_TAG_SCENE,
+    MEMORY_TAG_LOGGING,
+    MEMORY_TAG_PROFILER,
+    MEMORY_TAG_APPLICATION,
+
+    MEMORY_TAG_COUNT
+} memory_tag;
+
+typedef struct memory_tag_stats
+{
+    s64 live_bytes;
+    s64 live_count;
+    /** highest live_bytes since startup */
+    s64 peak_bytes;
+    s64 total_alloc_count;
+    /** allocations made during the last completed frame */
+    s64 frame_alloc_count;
+    s64 frame_alloc_bytes;
+} memory_tag_stats;
+
+/**
+ * Tracked heap allocation, 16 byte aligned. A small header in front of the block keeps size, tag
+ * and call site, so the block has to be released with memory_tracker_free / WFREE.
+ */
+no_mangle warpunk_api void* memory_tracker_alloc(s64 size, memory_tag tag, const char* file, s32 line);
+
+/** */
+no_mangle warpunk_api void memory_tracker_free(void* memory);
+
+/** Grows or shrinks a tracked block in place where possible, keeps its tag. nullptr allocates, size 0 frees. */
+no_mangle warpunk_api void* memory_tracker_realloc(void* memory, s64 size, const char* file, s32 line);
+
+/** @returns the size requested for a tracked block. */
+no_mangle warpunk_api s64 memory_tracker_size(const void* memory);
+
+/** Closes the per frame counters, called by memory_system_frame_reset. */
+no_mangle warpunk_api void memory_tracker_frame_end();
+
+/** */
+no_mangle warpunk_api void memory_tracker_get_stats(memory_tag tag, memory_tag_stats* out_stats);
+
+/** @returns the allocation count over all tags since startup, diff it around a hot path to catch allocations. */
+no_mangle warpunk_api s64 memory_tracker_total_alloc_count();
+
+/** Warns once when the live bytes of `tag` exceed `budget_bytes`, 0 removes the budget. */
+no_mangle warpunk_api void memory_tracker_set_budget(memory_tag tag, s64 budget_bytes);
+
+/** Logs live, peak and last frame numbers of every tag that was used. */
+no_mangle warpunk_api void memory_tracker_log_usage();
+
+/**
+ * While enabled every allocation is also counted per call site, with a lock around the site table.
+ * Blocks allocated before enabling are not attributed.
+ */
+no_mangle warpunk_api void memory_tracker_trace_enable(b8 enable);
+
+/** Logs the traced call sites, the ones allocating most often first. */
+no_mangle warpunk_api void memory_tracker_trace_dump();
+
+/** @returns the name of the tag as it appears in the logs. */
+no_mangle warpunk_api const char* memory_tag_name(memory_tag tag);
+
+#define WALLOC(size, tag) memory_tracker_alloc((size), (tag), __FILE__, __LINE__)
+#define WREALLOC(memory, size) memory_tracker_realloc((memory), (size), __FILE__, __LINE__)
+#define WFREE(memory) memory_tracker_free(memory)
@@ -0,0 +1,90 @@
+#include "warpunk.core/src/memory/pool.h"
+
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/logger.h"
+
+b8 pool_create(pool* out_pool, s64 block_size, s64 block_count, memory_tag tag)
+{
+    block_size = (block_size < (s64)sizeof(void*)) ? (s64)sizeof(void*) : block_size;
+    block_size = (block_size + POOL_ALIGNMENT - 1) & ~(s64)(POOL_ALIGNMENT - 1);
+
+    out_pool->memory = (u8 *)WALLOC(block_size * block_count, tag);
+    if (out_pool->memory == nullptr)
+    {
+        WERROR("Failed to allocate a pool of %lld blocks of %lld bytes", (long long)block_count, (long long)block_size);
+        *out_pool = {};
+        return false;
+    }
+
+    out_pool->block_size = block_size;
+    out_pool->block_count = block_count;
+    out_pool->used_count = 0;
+
+    /** thread the free list through the blocks in address order */
+    out_pool->free_list = nullptr;
+    for (s64 block_idx = block_count - 1; block_idx >= 0; --block_idx)
+    {
+        void** block = (void **)(out_pool->memory + block_idx * block_size);
+        *block = out_pool->free_list;
+        out_pool->free_list = block;
+    }
+    return true;
+}
+
+void pool_destroy(pool* pool)
+{
+    WFREE(pool->memory);
+    *pool = {};
+}
+
+void* pool_alloc(pool* pool)
+{
+    void** block = (void **)pool->free_list;
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    pool->free_list = *block;
+    pool->used_count++;
+    return block;
+}
+
+void pool_free(pool* pool, void* memory)
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    void** block = (void **)memory;
+    *block = pool->free_list;
+    pool->free_list = block;
+    pool->used_count--;
+}
+
+b8 pool_owns(const pool* pool, const void* memory)
+{
+    const u8* address = (const u8 *)memory;
+    return address >= pool->memory && address < pool->memory + pool->block_size * pool->block_count;
+}
+
+static void* pool_allocator_alloc(void* context, s64 size)
+{
+    pool* pool = (struct pool *)context;
+    if (size > pool->block_size)
+    {
+        return nullptr;
+    }
+    return pool_alloc(pool);
+}
+
+static void pool_allocator_free(void* context, void* memory)
+{
+    pool_free((pool *)context, memory);
+}
+
+allocator pool_allocator(pool* pool)
+{
+    return allocator { .alloc = pool_allocator_alloc, .free = pool_allocator_free, .context = pool };
+}
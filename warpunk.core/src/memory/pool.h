@@ -0,0 +1,35 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/memory/allocator.h"
+
+#define POOL_ALIGNMENT 16
+
+/** @brief Fixed number of equally sized blocks, the free blocks form an intrusive list. */
+typedef struct pool
+{
+    u8* memory;
+    s64 block_size;
+    s64 block_count;
+    s64 used_count;
+    /** first free block, every free block stores the address of the next one */
+    void* free_list;
+} pool;
+
+/** `block_size` is rounded up to POOL_ALIGNMENT, the backing block is counted under `tag`. */
+no_mangle warpunk_api b8 pool_create(pool* out_pool, s64 block_size, s64 block_count, memory_tag tag);
+
+/** */
+no_mangle warpunk_api void pool_destroy(pool* pool);
+
+/** @returns a block in O(1), nullptr if every block is in use. The memory is not zeroed. */
+no_mangle warpunk_api void* pool_alloc(pool* pool);
+
+/** Returns a block in O(1), `memory` has to come from this pool. */
+no_mangle warpunk_api void pool_free(pool* pool, void* memory);
+
+/** @returns true if `memory` points into the pool's block range. */
+no_mangle warpunk_api b8 pool_owns(const pool* pool, const void* memory);
+
+/** @returns an allocator backed by `pool`, requests larger than the block size fail. */
+no_mangle warpunk_api allocator pool_allocator(pool* pool);
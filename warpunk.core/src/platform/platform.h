@@ -41,6 +41,28 @@ typedef struct platform_window_info
     platform_window_mode platform_window_mode;
 } platform_window_info;
 
+typedef enum platform_backend
+{
+    /** a window on the X display, headless if there is no display */
+    PLATFORM_BACKEND_AUTO,
+    PLATFORM_BACKEND_WINDOWED,
+    /** a virtual window without display: frames go to an in-memory sink, input comes from platform_push_event */
+    PLATFORM_BACKEND_HEADLESS
+} platform_backend;
+
+typedef struct platform_config
+{
+    platform_backend backend;
+    /** size of the window or of the virtual window, 0 defaults to 960x540 */
+    s16 window_width;
+    s16 window_height;
+    /**
+     * Reads the window's events on a dedicated thread that blocks on the X connection and timestamps them as they
+     * arrive, platform_process_input only drains what the thread queued. Ignored by the headless backend.
+     */
+    b8 use_input_thread;
+} platform_config;
+
 typedef u32 thread_ticket;
 typedef struct platform_threading_job
 {
@@ -50,7 +72,10 @@ typedef struct platform_threading_job
 } platform_threading_job;
 
 /** */
-no_mangle warpunk_api bool platform_startup();
+no_mangle warpunk_api bool platform_startup(platform_config config);
+
+/** @returns true if platform_startup chose the headless backend, there is no window handle to render to. */
+no_mangle warpunk_api b8 platform_is_headless();
 
 /** */
 no_mangle warpunk_api void platform_shutdown();
@@ -89,6 +114,9 @@ no_mangle warpunk_api void* platform_memory_alloc(s64 size);
 /** */
 no_mangle warpunk_api void platform_memory_free(void* src);
 
+/** Grows or shrinks a block from platform_memory_alloc, large blocks are remapped instead of copied where the OS can. */
+no_mangle warpunk_api void* platform_memory_realloc(void* src, s64 size);
+
 /** */
 no_mangle warpunk_api void platform_memory_copy(void* dst, void* src, s64 size);
 
@@ -98,6 +126,46 @@ no_mangle warpunk_api void platform_memory_set(void* dst, s64 size, s32 value);
 /** */
 no_mangle warpunk_api void platform_memory_zero(void* dst, s64 size);
 
+/**
+ * =================== PLATFORM FILES ===================
+ */
+
+/** @brief A file mapped into memory, stores to `memory` end up in the file without a syscall. */
+typedef struct platform_mapped_file
+{
+    void* memory;
+    s64 size;
+    s64 handle;
+} platform_mapped_file;
+
+/** Creates or truncates `path`, preallocates `size` bytes on disk and maps them writable. */
+no_mangle warpunk_api b8 platform_mapped_file_create(const char* path, s64 size, platform_mapped_file* out_file);
+
+/** Writes the dirty pages back to disk, blocks until they are written. */
+no_mangle warpunk_api void platform_mapped_file_sync(platform_mapped_file* file);
+
+/** Unmaps the file and cuts it to the `used_size` bytes that were written. */
+no_mangle warpunk_api void platform_mapped_file_close(platform_mapped_file* file, s64 used_size);
+
+/** Replaces `new_path` if it exists. */
+no_mangle warpunk_api b8 platform_file_rename(const char* path, const char* new_path);
+
+/** */
+no_mangle warpunk_api b8 platform_file_delete(const char* path);
+
+/**
+ * =================== PLATFORM CRASH ===================
+ */
+
+/** Runs on the crashing thread, only the crash handler's own state is consistent at that point. */
+typedef void (*platform_crash_handler_t)(s32 signal);
+
+/**
+ * Calls `handler` on a fatal signal (segmentation fault, bus error, illegal instruction, floating point
+ * exception, abort) before the process dies as it would without the handler. nullptr removes it.
+ */
+no_mangle warpunk_api void platform_register_crash_handler(platform_crash_handler_t handler);
+
 /**
  * =================== PLATFORM CONSOLE ===================
  */
@@ -108,17 +176,99 @@ no_mangle warpunk_api void platform_console_write(log_level level, const char* m
  * =================== PLATFORM CLOCK ===================
  */
 
+/** @returns seconds on a monotonic clock, derived from the tick counter. */
 no_mangle warpunk_api f64 platform_get_absolute_time();
 
 /**
- * =================== PLATFORM THREADING ===================
+ * @returns a monotonic tick count, cheap enough to time single zones or tiles. Ticks are only meaningful
+ * relative to each other, convert differences with platform_ticks_to_seconds or platform_ticks_to_ns.
+ * This is the invariant TSC where the CPU has one and CLOCK_MONOTONIC nanoseconds otherwise, the first
+ * call calibrates the TSC which takes about 10 ms.
  */
+no_mangle warpunk_api u64 platform_get_ticks();
+
+/** Like platform_get_ticks, but only reads the counter after every earlier instruction finished. */
+no_mangle warpunk_api u64 platform_get_ticks_ordered();
 
 /** */
-no_mangle warpunk_api void platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket);
+no_mangle warpunk_api f64 platform_get_ticks_per_second();
 
 /** */
-no_mangle warpunk_api void platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time);
+no_mangle warpunk_api f64 platform_ticks_to_seconds(u64 ticks);
+
+/** */
+no_mangle warpunk_api u64 platform_ticks_to_ns(u64 ticks);
+
+/**
+ * =================== PLATFORM PERFORMANCE COUNTERS ===================
+ */
+
+typedef enum platform_perf_counter
+{
+    PLATFORM_PERF_COUNTER_CYCLES,
+    PLATFORM_PERF_COUNTER_INSTRUCTIONS,
+    PLATFORM_PERF_COUNTER_LLC_MISSES,
+    PLATFORM_PERF_COUNTER_BRANCH_MISSES,
+    PLATFORM_PERF_COUNTER_DTLB_MISSES,
+    PLATFORM_PERF_COUNTER_COUNT
+} platform_perf_counter;
+
+/** @brief Hardware event counts of one thread, only differences of two reads are meaningful. */
+typedef struct platform_perf_counters
+{
+    u64 values[PLATFORM_PERF_COUNTER_COUNT];
+} platform_perf_counters;
+
+/**
+ * Reads the hardware counters of the calling thread, the first read on a thread opens them as one group so
+ * they are always counted over the same instructions. Costs a system call, read around frames or zones
+ * rather than inside hot loops.
+ * @returns false if the counters are unavailable: no PMU (most VMs), perf_event_paranoid or other platforms.
+ */
+no_mangle warpunk_api b8 platform_perf_counters_read(platform_perf_counters* out_counters);
+
+/**
+ * =================== PLATFORM THREADING ===================
+ */
+
+/** Suspends the calling thread for at least `seconds`. */
+no_mangle warpunk_api void platform_sleep(f64 seconds);
+
+/** Suspends the calling thread until at least `absolute_time` on the platform_get_absolute_time clock. */
+no_mangle warpunk_api void platform_sleep_until(f64 absolute_time);
+
+/**
+ * Suspends the calling thread while `*address` holds `expected`, for at most `timeout_seconds` or until woken
+ * when negative. Can return early, the caller rechecks its condition.
+ */
+no_mangle warpunk_api void platform_address_wait(u32* address, u32 expected, f64 timeout_seconds);
+
+/** Wakes every thread waiting in platform_address_wait on `address`. */
+no_mangle warpunk_api void platform_address_wake(u32* address);
+
+/** Runs `chunk_count` jobs, job i receives its own copy of the i-th `arg_size` block of `jobs->arg`. */
+no_mangle warpunk_api b8 platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket);
+
+/**
+ * Waits for all jobs of the ticket and releases it.
+ * `cancellation_time` is an absolute deadline on the platform_get_absolute_time clock, 0 waits 
+ * without deadline. Jobs still running at the deadline are cancelled and joined as soon as they
+ * observe platform_threadpool_is_cancelled.
+ * @returns false if the jobs had to be cancelled.
+ */
+no_mangle warpunk_api b8 platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time);
+
+/** Waits up to `timeout_seconds`, returns true and releases the ticket once all jobs finished. */
+no_mangle warpunk_api b8 platform_threadpool_wait(thread_ticket ticket, f64 timeout_seconds);
+
+/** Non blocking variant of platform_threadpool_wait. */
+no_mangle warpunk_api b8 platform_threadpool_try_wait(thread_ticket ticket);
+
+/** Asks all jobs of the ticket to stop, the ticket still has to be waited for. */
+no_mangle warpunk_api void platform_threadpool_cancel(thread_ticket ticket);
+
+/** Polled by jobs, true once the ticket of the calling job was cancelled. */
+no_mangle warpunk_api b8 platform_threadpool_is_cancelled();
 
 /**
  * =================== PLATFORM EVENTS ===================
@@ -144,4 +294,84 @@ typedef void (*platform_mouse_wheel_event_t)(s32 delta);
 /** */
 no_mangle warpunk_api void platform_register_mouse_wheel_event(platform_mouse_wheel_event_t callback);
 
+/** Called when the window is hidden (minimized) or shown and when it loses or gains the focus. */
+typedef void (*platform_window_state_event_t)(b8 is_visible, b8 is_focused);
+/** */
+no_mangle warpunk_api void platform_register_window_state_event(platform_window_state_event_t callback);
+
+/** Called when the window is closed or escape is pressed, the platform stays up until platform_shutdown. */
+typedef void (*platform_window_close_event_t)();
+/** */
+no_mangle warpunk_api void platform_register_window_close_event(platform_window_close_event_t callback);
+
+/**
+ * Blocks until the window has events to process or `timeout_seconds` passed, without using the CPU.
+ * For idle loops, platform_process_input has to drain the events before waiting again.
+ * @returns true if events arrived.
+ */
+no_mangle warpunk_api b8 platform_wait_for_events(f64 timeout_seconds);
+
+/**
+ * @returns the platform_get_ticks timestamp of the oldest event the last platform_process_input delivered,
+ * 0 if it delivered none. The start of the event to present latency of the frame that processes them.
+ */
+no_mangle warpunk_api u64 platform_get_oldest_event_ticks();
 
+/**
+ * =================== PLATFORM HEADLESS ===================
+ */
+
+typedef enum platform_event_type
+{
+    PLATFORM_EVENT_TYPE_KEY,
+    PLATFORM_EVENT_TYPE_MOUSE_BUTTON,
+    PLATFORM_EVENT_TYPE_MOUSE_MOVE,
+    PLATFORM_EVENT_TYPE_MOUSE_WHEEL,
+    PLATFORM_EVENT_TYPE_WINDOW_STATE,
+    /** the window manager asked to close the window */
+    PLATFORM_EVENT_TYPE_WINDOW_CLOSE
+} platform_event_type;
+
+/** @brief An input or window event in the form the registered callbacks receive it. */
+typedef struct platform_event
+{
+    platform_event_type type;
+    /** platform_get_ticks when the event arrived, platform_push_event stamps events that have none */
+    u64 ticks;
+    union
+    {
+        struct { keycode keycode; b8 pressed; } key;
+        struct { mouse_button mouse_button; b8 pressed; } mouse_button;
+        struct { s16 x; s16 y; } mouse_move;
+        struct { s32 delta; } mouse_wheel;
+        struct { b8 is_visible; b8 is_focused; } window_state;
+    };
+} platform_event;
+
+/**
+ * Queues a synthetic event, the next platform_process_input delivers it to the registered callbacks like one
+ * from the window. The input source of the headless backend, works with a window as well. Safe from any thread.
+ * @returns false if the queue is full or the platform is not started.
+ */
+no_mangle warpunk_api b8 platform_push_event(const platform_event* event);
+
+/** @brief The last frame presented to the headless backend. */
+typedef struct platform_headless_frame
+{
+    s32 width;
+    s32 height;
+    /** bytes of the frame, the pixels are in the renderer's present format */
+    s32 size;
+    /** frames presented since platform_startup */
+    u64 frame_count;
+} platform_headless_frame;
+
+/** Copies a presented frame into the in-memory sink, what the headless backend has instead of a window. */
+no_mangle warpunk_api b8 platform_headless_submit_framebuffer(s32 width, s32 height, s32 size, const u8* framebuffer);
+
+/**
+ * Copies the last presented frame to `out_pixels` if it fits into `capacity` bytes, nullptr only reads `out_frame`.
+ * Safe while the renderer presents on another thread.
+ * @returns false if nothing was presented yet.
+ */
+no_mangle warpunk_api b8 platform_headless_read_framebuffer(platform_headless_frame* out_frame, u8* out_pixels, s64 capacity);
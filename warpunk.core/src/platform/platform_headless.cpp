@@ -0,0 +1,190 @@
+#include "warpunk.core/src/platform/platform_headless.h"
+
+#include "warpunk.core/src/container/mpmcqueue.hpp"
+#include "warpunk.core/src/memory/memory_tracker.h"
+
+/** synthetic events between two platform_process_input calls, a replayed frame rarely has more than a few */
+#define PLATFORM_EVENT_QUEUE_CAPACITY 4096
+
+typedef struct platform_headless_state
+{
+    b8 is_headless;
+    b8 is_initialized;
+    s16 window_width;
+    s16 window_height;
+
+    mpmcqueue<platform_event> events;
+    /** pushed and not yet popped, lets the wait sleep without touching the queue */
+    s64 pending_event_count;
+    /** bumped on every push, the headless wait sleeps on it */
+    u32 event_sequence;
+
+    /** guards the sink, the renderer presents from its own thread */
+    b8 framebuffer_lock;
+    u8* framebuffer;
+    s64 framebuffer_capacity;
+    platform_headless_frame frame;
+} platform_headless_state;
+
+static platform_headless_state state;
+
+static void platform_headless_lock()
+{
+    while (__atomic_test_and_set(&state.framebuffer_lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void platform_headless_unlock()
+{
+    __atomic_clear(&state.framebuffer_lock, __ATOMIC_RELEASE);
+}
+
+b8 platform_headless_startup(b8 is_headless, s16 window_width, s16 window_height)
+{
+    if (!mpmcqueue_create(&state.events, PLATFORM_EVENT_QUEUE_CAPACITY, allocator_heap(MEMORY_TAG_PLATFORM)))
+    {
+        WERROR("Failed to create the synthetic event queue.");
+        return false;
+    }
+
+    state.is_headless = is_headless;
+    state.window_width = window_width;
+    state.window_height = window_height;
+    state.pending_event_count = 0;
+    state.frame = {};
+    __atomic_store_n(&state.is_initialized, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+void platform_headless_shutdown()
+{
+    if (!state.is_initialized)
+    {
+        return;
+    }
+
+    __atomic_store_n(&state.is_initialized, false, __ATOMIC_RELEASE);
+    mpmcqueue_destroy(&state.events);
+    WFREE(state.framebuffer);
+    state.framebuffer = nullptr;
+    state.framebuffer_capacity = 0;
+}
+
+b8 platform_is_headless()
+{
+    return state.is_headless;
+}
+
+b8 platform_push_event(const platform_event* event)
+{
+    platform_event stamped_event = *event;
+    if (stamped_event.ticks == 0)
+    {
+        stamped_event.ticks = platform_get_ticks();
+    }
+
+    if (!__atomic_load_n(&state.is_initialized, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    // counted before the push, a consumer that pops it right away must not take the count below zero
+    __atomic_fetch_add(&state.pending_event_count, 1, __ATOMIC_RELAXED);
+    if (!mpmcqueue_push(&state.events, stamped_event))
+    {
+        __atomic_fetch_sub(&state.pending_event_count, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    __atomic_fetch_add(&state.event_sequence, 1, __ATOMIC_SEQ_CST);
+    platform_address_wake(&state.event_sequence);
+    return true;
+}
+
+b8 platform_pop_event(platform_event* out_event)
+{
+    if (!state.is_initialized || !mpmcqueue_pop(&state.events, out_event))
+    {
+        return false;
+    }
+
+    __atomic_fetch_sub(&state.pending_event_count, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+b8 platform_headless_wait_for_events(f64 timeout_seconds)
+{
+    f64 deadline = platform_get_absolute_time() + timeout_seconds;
+    while (true)
+    {
+        // read before the count, a push after the check changes it and the wait returns right away
+        u32 event_sequence = __atomic_load_n(&state.event_sequence, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&state.pending_event_count, __ATOMIC_ACQUIRE) > 0)
+        {
+            return true;
+        }
+
+        f64 remaining_seconds = -1.0;
+        if (timeout_seconds >= 0.0)
+        {
+            remaining_seconds = deadline - platform_get_absolute_time();
+            if (remaining_seconds <= 0.0)
+            {
+                return false;
+            }
+        }
+        platform_address_wait(&state.event_sequence, event_sequence, remaining_seconds);
+    }
+}
+
+void platform_headless_get_window_size(s16* out_width, s16* out_height)
+{
+    *out_width = state.window_width;
+    *out_height = state.window_height;
+}
+
+b8 platform_headless_submit_framebuffer(s32 width, s32 height, s32 size, const u8* framebuffer)
+{
+    platform_headless_lock();
+    if (state.framebuffer_capacity < size)
+    {
+        /** the old frame is overwritten anyway, no need to copy it over */
+        WFREE(state.framebuffer);
+        state.framebuffer = (u8 *)WALLOC(size, MEMORY_TAG_PLATFORM);
+        state.framebuffer_capacity = (state.framebuffer != nullptr) ? size : 0;
+        if (state.framebuffer == nullptr)
+        {
+            state.frame = {};
+            platform_headless_unlock();
+            WERROR("Failed to allocate the headless framebuffer of %d bytes.", size);
+            return false;
+        }
+    }
+
+    platform_memory_copy(state.framebuffer, (void *)framebuffer, size);
+    state.frame.width = width;
+    state.frame.height = height;
+    state.frame.size = size;
+    state.frame.frame_count++;
+    platform_headless_unlock();
+    return true;
+}
+
+b8 platform_headless_read_framebuffer(platform_headless_frame* out_frame, u8* out_pixels, s64 capacity)
+{
+    platform_headless_lock();
+    *out_frame = state.frame;
+    if (state.frame.frame_count == 0)
+    {
+        platform_headless_unlock();
+        return false;
+    }
+
+    if (out_pixels != nullptr && capacity >= state.frame.size)
+    {
+        platform_memory_copy(out_pixels, state.framebuffer, state.frame.size);
+    }
+    platform_headless_unlock();
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+
+/** Shared by the platform files: the synthetic event queue and the framebuffer sink of the headless backend. */
+
+/** Creates the event queue, `is_headless` is what platform_is_headless reports from then on. */
+b8 platform_headless_startup(b8 is_headless, s16 window_width, s16 window_height);
+
+/** */
+void platform_headless_shutdown();
+
+/** @returns false if no synthetic event is queued. */
+b8 platform_pop_event(platform_event* out_event);
+
+/** Sleeps until an event is pushed or `timeout_seconds` passed, the wait of the headless backend. */
+b8 platform_headless_wait_for_events(f64 timeout_seconds);
+
+/** Size of the virtual window. */
+void platform_headless_get_window_size(s16* out_width, s16* out_height);
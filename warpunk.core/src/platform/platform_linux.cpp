@@ -3,20 +3,36 @@
 
 #include "warpunk.core/src/platform/platform.h"
 #include "warpunk.core/src/platform/platform_linux.h"
+#include "warpunk.core/src/platform/platform_headless.h"
 #include "warpunk.core/src/input_system/input_types.h"
 #include "warpunk.core/src/container/stcqueue.hpp"
 #include "warpunk.core/src/container/dynqueue.hpp"
 #include "warpunk.core/src/container/dynarray.hpp"
+#include "warpunk.core/src/container/spscqueue.hpp"
+#include "warpunk.core/src/memory/arena.h"
+#include "warpunk.core/src/utils/profiler.h"
 
 #include <cassert>
 #include <cstdlib>
 #include <cstdio>
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <poll.h>
 #include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 #include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
 #include <X11/X.h>
@@ -46,9 +62,20 @@
 #define PLATFORM_MOUSE_BUTTON_8 15
 #define PLATFORM_MOUSE_BUTTON_9 16
 
+#define PLATFORM_DEFAULT_WINDOW_WIDTH 960
+#define PLATFORM_DEFAULT_WINDOW_HEIGHT 540
+
+/** window events the input thread can be ahead of the frame loop */
+#define PLATFORM_INPUT_QUEUE_CAPACITY 4096
+/** how long the input thread backs off while the frame loop stalls with a full queue */
+#define PLATFORM_INPUT_QUEUE_FULL_SLEEP_SECONDS 0.001
+
 #define PLATFORM_THREADPOOL_THREAD_COUNT 32
+/** initial size of a ticket's arena, it only grows if a batch does not fit */
+#define PLATFORM_THREADPOOL_ARENA_SIZE (16 * 1024)
 
 static keycode translate_keycode(const unsigned int key_code);
+static b8 translate_mouse_button(u8 button, mouse_button* out_mouse_button);
 static void* platform_thread_main_routine(void* args);
 
 typedef struct thread_handle
@@ -59,20 +86,31 @@ typedef struct thread_handle
 
 typedef struct thread_context
 {
+    /** holds the arrays below and the job arguments, reset when the ticket is released */
+    arena arena;
     dynarray<pthread_t> threads;
     dynarray<platform_threading_job> jobs;
     dynarray<thread_handle> handles;
     s64 active_thread_count;
+    /** set by sync/cancel, polled by the jobs through platform_threadpool_is_cancelled */
+    b8 is_cancelled;
+    b8 is_initialized;
     pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER; 
+    /** signaled when the last job of the ticket finished */
+    pthread_cond_t finished;
 } thread_context;
 
 typedef struct linux_state
 {
     Display* display;
     linux_handle handle;
+    /** no display connection, every window function works on the virtual window */
+    b8 is_headless;
 
-    pthread_mutex_t mutex;
-    b8 thread_ticket_free_list[64] = { true };
+    /** statically initialized, the threadpool is used before platform_startup (the logger writer) */
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    /** zero initialized, so every ticket starts out free */
+    b8 thread_ticket_in_use[64];
     thread_context thread_contexts[64];
 
 
@@ -80,11 +118,36 @@ typedef struct linux_state
     platform_mouse_button_event_t mouse_button_event;
     platform_mouse_move_event_t mouse_move_event;
     platform_mouse_wheel_event_t mouse_wheel_event;
+    platform_window_state_event_t window_state_event;
+    platform_window_close_event_t window_close_event;
+    /** mapped and focused, the window manager unmaps minimized windows */
+    b8 is_window_visible;
+    b8 is_window_focused;
+    /** the window state as of the last translated event, owned by whichever thread translates them */
+    b8 is_event_window_visible;
+    b8 is_event_window_focused;
+    /** timestamp of the oldest event delivered by the running platform_process_input, 0 if none */
+    u64 oldest_event_ticks;
+
+    /** producer: the input thread, consumer: platform_process_input */
+    spscqueue<platform_event> input_events;
+    pthread_t input_thread;
+    b8 is_input_thread_running;
+    b8 is_input_thread_stopping;
+    /** client message that wakes the input thread from its blocking wait to exit */
+    xcb_atom_t input_thread_stop_atom;
+    /** eventfd the input thread signals after queueing events, platform_wait_for_events polls it */
+    s32 input_wake_fd;
+
+    platform_crash_handler_t crash_handler;
 } linux_state;
 
 // NOTE: Global
 static linux_state state;
 
+/** ticket of the job running on the calling thread, -1 outside of the threadpool */
+static thread_local s64 current_thread_ticket = -1;
+
 static const char* platform_get_error_name(uint8_t error_code)
 {
     switch (error_code) 
@@ -151,8 +214,15 @@ xcb_atom_t platform_get_atom(const char* name)
     return atom;
 }
 
-bool platform_startup()
+/** opens the display and maps the window, false without a reachable X server */
+static b8 platform_create_window(s32 window_width, s32 window_height, b8 use_input_thread)
 {
+    /** the input thread translates keys through Xlib while the main thread uses the display */
+    if (use_input_thread)
+    {
+        XInitThreads();
+    }
+
     state.display = XOpenDisplay(NULL);
     if (state.display == NULL)
     {
@@ -179,10 +249,8 @@ bool platform_startup()
         XCB_EVENT_MASK_EXPOSURE | 
         XCB_EVENT_MASK_KEY_PRESS | XCB_EVENT_MASK_KEY_RELEASE | 
         XCB_EVENT_MASK_BUTTON_PRESS | XCB_EVENT_MASK_BUTTON_RELEASE | 
-        XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_STRUCTURE_NOTIFY };
+        XCB_EVENT_MASK_POINTER_MOTION | XCB_EVENT_MASK_STRUCTURE_NOTIFY | XCB_EVENT_MASK_FOCUS_CHANGE };
 
-    s32 window_width = 960;
-    s32 window_height = 540;
     s32 border_width = 0;
 
     if (!platform_result_is_success(xcb_create_window_checked(
@@ -209,175 +277,371 @@ bool platform_startup()
         WERROR("Failed to map window.\n");
     }
 
+    /**
+     * a new window counts as focused, the window manager may never send a FocusIn for it. Only an unmap or a
+     * FocusOut suspends the engine. */
+    state.is_window_focused = true;
+    state.is_event_window_focused = true;
+
     xcb_flush(state.handle.connection);
+    return true;
+}
+
+/**
+ * Turns a window event into the platform's form and stamps it with the current ticks.
+ * @returns false for events the platform does not report.
+ */
+static b8 platform_translate_event(xcb_generic_event_t* event, platform_event* out_event)
+{
+    *out_event = {};
+    out_event->ticks = platform_get_ticks();
+
+    switch (event->response_type & ~0x80) 
+    {
+        case XCB_KEY_PRESS:
+        case XCB_KEY_RELEASE:
+        {
+            xcb_key_press_event_t* key_event = reinterpret_cast<xcb_key_press_event_t*>(event);
+            KeySym key_sym = XkbKeycodeToKeysym(state.display, key_event->detail, 0, 0);
+            out_event->type = PLATFORM_EVENT_TYPE_KEY;
+            out_event->key.keycode = translate_keycode(key_sym);
+            out_event->key.pressed = key_event->response_type == XCB_KEY_PRESS; 
+        } return true;
+
+        case XCB_BUTTON_PRESS:
+        case XCB_BUTTON_RELEASE:
+        {
+            xcb_button_press_event_t* mouse_event = reinterpret_cast<xcb_button_press_event_t*>(event);
+            b8 pressed = mouse_event->response_type == XCB_BUTTON_PRESS;
+            if (mouse_event->detail == PLATFORM_MOUSE_WHEEL_UP || mouse_event->detail == PLATFORM_MOUSE_WHEEL_DOWN)
+            {
+                out_event->type = PLATFORM_EVENT_TYPE_MOUSE_WHEEL;
+                out_event->mouse_wheel.delta = pressed ? ((mouse_event->detail == PLATFORM_MOUSE_WHEEL_UP) ? 1 : -1) : 0;
+                return true;
+            }
+
+            out_event->type = PLATFORM_EVENT_TYPE_MOUSE_BUTTON;
+            out_event->mouse_button.pressed = pressed;
+            return translate_mouse_button(mouse_event->detail, &out_event->mouse_button.mouse_button);
+        }
+
+        case XCB_MOTION_NOTIFY:
+        {
+            xcb_motion_notify_event_t* motion_event = reinterpret_cast<xcb_motion_notify_event_t*>(event);
+            out_event->type = PLATFORM_EVENT_TYPE_MOUSE_MOVE;
+            out_event->mouse_move.x = motion_event->event_x;
+            out_event->mouse_move.y = motion_event->event_y;
+        } return true;
+
+        case XCB_CONFIGURE_NOTIFY:
+        {
+            // TODO: reszie window
+        } return false;
+
+        case XCB_MAP_NOTIFY:
+        case XCB_UNMAP_NOTIFY:
+        {
+            state.is_event_window_visible = (event->response_type & ~0x80) == XCB_MAP_NOTIFY;
+            out_event->type = PLATFORM_EVENT_TYPE_WINDOW_STATE;
+            out_event->window_state.is_visible = state.is_event_window_visible;
+            out_event->window_state.is_focused = state.is_event_window_focused;
+        } return true;
+
+        case XCB_FOCUS_IN:
+        case XCB_FOCUS_OUT:
+        {
+            xcb_focus_in_event_t* focus_event = reinterpret_cast<xcb_focus_in_event_t*>(event);
+
+            /** grabs (alt-tab, window moves) focus and unfocus the window temporarily, ignore them */
+            if (focus_event->mode != XCB_NOTIFY_MODE_NORMAL && focus_event->mode != XCB_NOTIFY_MODE_WHILE_GRABBED)
+            {
+                return false;
+            }
+
+            state.is_event_window_focused = (event->response_type & ~0x80) == XCB_FOCUS_IN;
+            out_event->type = PLATFORM_EVENT_TYPE_WINDOW_STATE;
+            out_event->window_state.is_visible = state.is_event_window_visible;
+            out_event->window_state.is_focused = state.is_event_window_focused;
+        } return true;
+    
+        case XCB_CLIENT_MESSAGE:
+        {
+            xcb_client_message_event_t* client_event = reinterpret_cast<xcb_client_message_event_t*>(event);
+            out_event->type = PLATFORM_EVENT_TYPE_WINDOW_CLOSE;
+            return client_event->data.data32[0] == 0;
+        }
+    }
+
+    return false;
+}
+
+/** blocks on the X connection so events are stamped when they arrive rather than when the frame loop polls */
+static void* platform_input_thread_main([[maybe_unused]] void* args)
+{
+    xcb_generic_event_t* xcb_event;
+    while ((xcb_event = xcb_wait_for_event(state.handle.connection)))
+    {
+        b8 is_stop = (xcb_event->response_type & ~0x80) == XCB_CLIENT_MESSAGE &&
+                     reinterpret_cast<xcb_client_message_event_t*>(xcb_event)->type == state.input_thread_stop_atom;
+        platform_event event;
+        b8 is_translated = !is_stop && platform_translate_event(xcb_event, &event);
+        free(xcb_event);
+        if (is_stop)
+        {
+            break;
+        }
+        if (!is_translated)
+        {
+            continue;
+        }
+
+        /** rather than dropping input, leave it in the X connection until the frame loop catches up */
+        while (!spscqueue_push(&state.input_events, event))
+        {
+            if (__atomic_load_n(&state.is_input_thread_stopping, __ATOMIC_ACQUIRE))
+            {
+                return nullptr;
+            }
+            platform_sleep(PLATFORM_INPUT_QUEUE_FULL_SLEEP_SECONDS);
+        }
+
+        u64 wake = 1;
+        [[maybe_unused]] ssize_t _ = write(state.input_wake_fd, &wake, sizeof(wake));
+    }
 
-    /** threading */
-    pthread_mutex_init(&state.mutex, nullptr);
+    return nullptr;
+}
+
+static b8 platform_start_input_thread()
+{
+    state.input_thread_stop_atom = platform_get_atom("WARPUNK_INPUT_THREAD_STOP");
+    if (state.input_thread_stop_atom == XCB_ATOM_NONE)
+    {
+        return false;
+    }
+
+    if (!spscqueue_create(&state.input_events, PLATFORM_INPUT_QUEUE_CAPACITY, allocator_heap(MEMORY_TAG_PLATFORM)))
+    {
+        return false;
+    }
+
+    state.input_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (state.input_wake_fd == -1)
+    {
+        spscqueue_destroy(&state.input_events);
+        return false;
+    }
+
+    __atomic_store_n(&state.is_input_thread_stopping, false, __ATOMIC_RELAXED);
+    if (pthread_create(&state.input_thread, nullptr, platform_input_thread_main, nullptr) != 0)
+    {
+        close(state.input_wake_fd);
+        spscqueue_destroy(&state.input_events);
+        return false;
+    }
+
+    state.is_input_thread_running = true;
+    return true;
+}
+
+static void platform_stop_input_thread()
+{
+    if (!state.is_input_thread_running)
+    {
+        return;
+    }
+
+    state.is_input_thread_running = false;
+    __atomic_store_n(&state.is_input_thread_stopping, true, __ATOMIC_RELEASE);
+
+    /** an empty event mask sends the event to the window's own client, the input thread */
+    xcb_client_message_event_t event = {};
+    event.response_type = XCB_CLIENT_MESSAGE;
+    event.window = state.handle.window;
+    event.type = state.input_thread_stop_atom;
+    event.format = 32;
+    xcb_send_event(state.handle.connection, false, state.handle.window, XCB_EVENT_MASK_NO_EVENT, (const char*)&event);
+    xcb_flush(state.handle.connection);
+
+    pthread_join(state.input_thread, nullptr);
+    close(state.input_wake_fd);
+    spscqueue_destroy(&state.input_events);
+}
+
+bool platform_startup(platform_config config)
+{
+    s32 window_width = (config.window_width > 0) ? config.window_width : PLATFORM_DEFAULT_WINDOW_WIDTH;
+    s32 window_height = (config.window_height > 0) ? config.window_height : PLATFORM_DEFAULT_WINDOW_HEIGHT;
+
+    state.is_headless = (config.backend == PLATFORM_BACKEND_HEADLESS);
+    if (!state.is_headless && !platform_create_window(window_width, window_height, config.use_input_thread))
+    {
+        if (config.backend == PLATFORM_BACKEND_WINDOWED)
+        {
+            return false;
+        }
+
+        WWARNING("No X display, falling back to the headless platform backend.");
+        if (state.display != NULL)
+        {
+            XCloseDisplay(state.display);
+        }
+        state.display = NULL;
+        state.handle = {};
+        state.is_headless = true;
+    }
+
+    if (!platform_headless_startup(state.is_headless, (s16)window_width, (s16)window_height))
+    {
+        return false;
+    }
+
+    if (state.is_headless)
+    {
+        /** the virtual window is always shown and focused, synthetic window state events can change that */
+        state.is_window_visible = true;
+        state.is_window_focused = true;
+        WINFO("Started the headless platform backend with a %dx%d virtual window.", window_width, window_height);
+    }
+
+    if (!state.is_headless && config.use_input_thread && !platform_start_input_thread())
+    {
+        WWARNING("Failed to start the input thread, polling the window events on the main thread.");
+    }
 
     return true;
 }
 
 void platform_shutdown()
 {
-    xcb_disconnect(state.handle.connection);
+    platform_stop_input_thread();
+    platform_headless_shutdown();
+    if (state.handle.connection != nullptr)
+    {
+        xcb_disconnect(state.handle.connection);
+        state.handle.connection = nullptr;
+    }
 }
 
-void platform_process_input()
+/** reports the window state if a map or focus event changed it */
+static void platform_set_window_state(b8 is_visible, b8 is_focused)
+{
+    if (is_visible == state.is_window_visible && is_focused == state.is_window_focused)
+    {
+        return;
+    }
+
+    state.is_window_visible = is_visible;
+    state.is_window_focused = is_focused;
+    if (state.window_state_event)
+    {
+        state.window_state_event(is_visible, is_focused);
+    }
+}
+
+/** delivers an event to the callback it belongs to */
+static void platform_dispatch_event(const platform_event* event)
 {
-    xcb_generic_event_t* event;
-    while ((event = xcb_poll_for_event(state.handle.connection)))
+    if (state.oldest_event_ticks == 0 || event->ticks < state.oldest_event_ticks)
     {
-        switch (event->response_type & ~0x80) 
+        state.oldest_event_ticks = event->ticks;
+    }
+
+    switch (event->type)
+    {
+        case PLATFORM_EVENT_TYPE_KEY:
         {
-            case XCB_KEY_PRESS:
-            case XCB_KEY_RELEASE:
-            {
-                xcb_key_press_event_t* key_event = reinterpret_cast<xcb_key_press_event_t*>(event);
-                b8 pressed = key_event->response_type == XCB_KEY_PRESS; 
-                xcb_keycode_t code = key_event->detail;
-                KeySym key_sym = XkbKeycodeToKeysym(state.display, code, 0, 0);
-                keycode keycode = translate_keycode(key_sym);
-
-                state.keyboard_event(keycode, pressed);
-                
-                if (keycode == KEY_ESCAPE)
-                {
-                    platform_shutdown();
-                }
-            } break; 
+            state.keyboard_event(event->key.keycode, event->key.pressed);
+        } break;
 
-            case XCB_BUTTON_PRESS:
-            case XCB_BUTTON_RELEASE:
-            {
-                xcb_button_press_event_t* mouse_event = reinterpret_cast<xcb_button_press_event_t*>(event);
-                b8 pressed = mouse_event->response_type == XCB_BUTTON_PRESS;
-                mouse_button mouse_button = {}; 
-                switch (mouse_event->detail)
-                {
-                    case PLATFORM_MOUSE_BUTTON_LEFT:
-                    {
-                        mouse_button = MOUSE_BUTTON_LEFT;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_MIDDLE:
-                    {
-                        mouse_button = MOUSE_BUTTON_MIDDLE;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_RIGHT:
-                    {
-                        mouse_button = MOUSE_BUTTON_RIGHT;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_1:
-                    {
-                        mouse_button = MOUSE_BUTTON_1;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_2:
-                    {
-                        mouse_button = MOUSE_BUTTON_2;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_3:
-                    {
-                        mouse_button = MOUSE_BUTTON_3;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_4:
-                    {
-                        mouse_button = MOUSE_BUTTON_4;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_5:
-                    {
-                        mouse_button = MOUSE_BUTTON_5;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_6:
-                    {
-                        mouse_button = MOUSE_BUTTON_6;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_7:
-                    {
-                        mouse_button = MOUSE_BUTTON_7;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_8:
-                    {
-                        mouse_button = MOUSE_BUTTON_8;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_BUTTON_9:
-                    {
-                        mouse_button = MOUSE_BUTTON_9;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_WHEEL_LEFT:
-                    {
-                        mouse_button = MOUSE_WHEEL_LEFT;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;
-                    case PLATFORM_MOUSE_WHEEL_RIGHT:
-                    {
-                        mouse_button = MOUSE_WHEEL_RIGHT;
-                        state.mouse_button_event(mouse_button, pressed);
-                    } break;                        
-                }
+        case PLATFORM_EVENT_TYPE_MOUSE_BUTTON:
+        {
+            state.mouse_button_event(event->mouse_button.mouse_button, event->mouse_button.pressed);
+        } break;
 
-                u32 delta = 0;
-                switch (mouse_event->detail)
-                {
-                    case PLATFORM_MOUSE_WHEEL_UP:
-                    {
-                        delta = pressed ? 1 : 0; 
-                        state.mouse_wheel_event(delta);
-                    } break;
-                    case PLATFORM_MOUSE_WHEEL_DOWN:
-                    {
-                        delta = pressed ? -1 : 0;
-                        state.mouse_wheel_event(delta);
-                    } break;
-               
-                }
-            } break;
+        case PLATFORM_EVENT_TYPE_MOUSE_MOVE:
+        {
+            state.mouse_move_event(event->mouse_move.x, event->mouse_move.y);
+        } break;
 
-            case XCB_MOTION_NOTIFY:
-            {
-                xcb_motion_notify_event_t* motion_event = reinterpret_cast<xcb_motion_notify_event_t*>(event);
+        case PLATFORM_EVENT_TYPE_MOUSE_WHEEL:
+        {
+            state.mouse_wheel_event(event->mouse_wheel.delta);
+        } break;
 
-                state.mouse_move_event(motion_event->event_x, motion_event->event_y);
-            } break;
+        case PLATFORM_EVENT_TYPE_WINDOW_STATE:
+        {
+            platform_set_window_state(event->window_state.is_visible, event->window_state.is_focused);
+        } break;
 
-            case XCB_CONFIGURE_NOTIFY:
+        case PLATFORM_EVENT_TYPE_WINDOW_CLOSE:
+        {
+            if (state.window_close_event)
             {
-                xcb_configure_notify_event_t* configure_event = reinterpret_cast<xcb_configure_notify_event_t*>(event);
-            
-                u16 width = configure_event->width;
-                u16 height = configure_event->height;
+                state.window_close_event();
+            }
+        } break;
+    }
+}
 
-                // TODO: reszie window
-            } break;
-        
-            case XCB_CLIENT_MESSAGE:
-            {
-                xcb_client_message_event_t* client_event = reinterpret_cast<xcb_client_message_event_t*>(event);
+/** like platform_dispatch_event, escape on the real keyboard also closes the window */
+static void platform_dispatch_window_event(const platform_event* event)
+{
+    platform_dispatch_event(event);
+    if (event->type == PLATFORM_EVENT_TYPE_KEY && event->key.keycode == KEY_ESCAPE && state.window_close_event)
+    {
+        state.window_close_event();
+    }
+}
 
-                if (client_event->data.data32[0] == 0)
-                {
-                    platform_shutdown();
-                }
-            } break;
+void platform_process_input()
+{
+    WPROFILE_FUNCTION();
+
+    state.oldest_event_ticks = 0;
+
+    platform_event event;
+    while (platform_pop_event(&event))
+    {
+        platform_dispatch_event(&event);
+    }
+
+    if (state.is_input_thread_running)
+    {
+        /** already translated and stamped by the input thread */
+        while (spscqueue_pop(&state.input_events, &event))
+        {
+            platform_dispatch_window_event(&event);
         }
-        free(event);
+        return;
     }
+
+    if (state.is_headless)
+    {
+        return;
+    }
+
+    xcb_generic_event_t* xcb_event;
+    while (state.handle.connection != nullptr && (xcb_event = xcb_poll_for_event(state.handle.connection)))
+    {
+        b8 is_translated = platform_translate_event(xcb_event, &event);
+        free(xcb_event);
+        if (is_translated)
+        {
+            platform_dispatch_window_event(&event);
+        }
+    }
+}
+
+u64 platform_get_oldest_event_ticks()
+{
+    return state.oldest_event_ticks;
 }
 
 b8 platform_get_window_handle(s32* out_size, void* out_platform_handle)
 {
     *out_size = sizeof(linux_handle);
-    if (!out_platform_handle)
+    if (!out_platform_handle || state.is_headless)
     {
         return false; 
     }
@@ -439,6 +703,12 @@ b8 platform_get_function(library_context* library_context, function_description*
 
 b8 platform_is_mouse_inside_window()
 {
+    if (state.is_headless)
+    {
+        /** the synthetic pointer is wherever the last move event put it */
+        return true;
+    }
+
     xcb_connection_t* connection = state.handle.connection;
     xcb_window_t window = state.handle.window;
 
@@ -473,6 +743,11 @@ b8 platform_is_mouse_inside_window()
 
 b8 platform_set_window_mode(platform_window_mode platform_window_mode)
 {
+    if (state.is_headless)
+    {
+        return true;
+    }
+
     xcb_connection_t* connection = state.handle.connection;
     xcb_window_t window = state.handle.window;
     xcb_screen_t* screen = state.handle.screen;
@@ -536,6 +811,17 @@ b8 platform_get_window_info(platform_window_info* platform_window_info)
         return false;
     }
 
+    if (state.is_headless)
+    {
+        platform_headless_get_window_size(&platform_window_info->width, &platform_window_info->height);
+        platform_window_info->is_visible = state.is_window_visible;
+        platform_window_info->dpi_scale = 1.0f;
+        platform_window_info->monitor_index = 0;
+        platform_window_info->title = strdup("Headless");
+        platform_window_info->platform_window_mode = WINDOWED;
+        return true;
+    }
+
     xcb_connection_t* connection = state.handle.connection;
     xcb_window_t window = state.handle.window;
 
@@ -636,9 +922,7 @@ b8 platform_get_window_info(platform_window_info* platform_window_info)
         }
         
         free(wm_state_reply);
-    }    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
-    return now.tv_sec + now.tv_nsec * 0.000000001;
+    }
 
     return true;
 }
@@ -649,7 +933,8 @@ b8 platform_get_window_info(platform_window_info* platform_window_info)
 
 void* platform_memory_alloc(s64 size)
 {
-    void* memory = aligned_alloc(16, size);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    void* memory = aligned_alloc(16, (size + 15) & ~(s64)15);
     return memory;
 }
 
@@ -658,6 +943,12 @@ void platform_memory_free(void* src)
     free(src);
 }
 
+void* platform_memory_realloc(void* src, s64 size)
+{
+    // glibc keeps the 16 byte alignment of aligned_alloc and moves mmapped blocks with mremap
+    return realloc(src, size);
+}
+
 void platform_memory_copy(void* dst, void* src, s64 size)
 {
     memcpy(dst, src, size);
@@ -673,6 +964,107 @@ void platform_memory_zero(void* dst, s64 size)
     memset(dst, 0, size);
 }
 
+/**
+ * =================== PLATFORM FILES ===================
+ */
+
+b8 platform_mapped_file_create(const char* path, s64 size, platform_mapped_file* out_file)
+{
+    s32 fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // allocate the blocks up front, a full disk fails here instead of with SIGBUS on a store
+    if (posix_fallocate(fd, 0, size) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    out_file->memory = memory;
+    out_file->size = size;
+    out_file->handle = fd;
+    return true;
+}
+
+void platform_mapped_file_sync(platform_mapped_file* file)
+{
+    msync(file->memory, file->size, MS_SYNC);
+}
+
+void platform_mapped_file_close(platform_mapped_file* file, s64 used_size)
+{
+    munmap(file->memory, file->size);
+    if (ftruncate((s32)file->handle, used_size) != 0)
+    {
+        WWARNING("Failed to cut a mapped file to %lld bytes.", (long long)used_size);
+    }
+    close((s32)file->handle);
+    *file = {};
+}
+
+b8 platform_file_rename(const char* path, const char* new_path)
+{
+    return rename(path, new_path) == 0;
+}
+
+b8 platform_file_delete(const char* path)
+{
+    return unlink(path) == 0;
+}
+
+/**
+ * =================== PLATFORM CRASH ===================
+ */
+
+static const s32 platform_crash_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+
+static void platform_crash_signal_handler(s32 signal)
+{
+    platform_crash_handler_t handler = __atomic_load_n(&state.crash_handler, __ATOMIC_ACQUIRE);
+    if (handler != nullptr)
+    {
+        handler(signal);
+    }
+
+    // SA_RESETHAND restored the default action, raising again terminates the process like before
+    raise(signal);
+}
+
+void platform_register_crash_handler(platform_crash_handler_t handler)
+{
+    __atomic_store_n(&state.crash_handler, handler, __ATOMIC_RELEASE);
+    if (handler == nullptr)
+    {
+        return;
+    }
+
+    // a stack overflow leaves no stack to run the handler on, it gets its own
+    static u8 alternate_stack[64 * 1024];
+    stack_t signal_stack = {};
+    signal_stack.ss_sp = alternate_stack;
+    signal_stack.ss_size = sizeof(alternate_stack);
+    sigaltstack(&signal_stack, nullptr);
+
+    struct sigaction action = {};
+    action.sa_handler = platform_crash_signal_handler;
+    action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for (s32 crash_signal : platform_crash_signals)
+    {
+        sigaction(crash_signal, &action, nullptr);
+    }
+}
+
 /**
  * =================== PLATFORM CONSOLE ===================
  */
@@ -689,83 +1081,490 @@ void platform_console_write(log_level level, const char* message)
  * =================== PLATFORM CLOCK ===================
  */
 
-f64 platform_get_absolute_time()
+/** how long the TSC is compared against the monotonic clock, the error is about 100 ticks over this */
+#define LINUX_CLOCK_CALIBRATION_SECONDS 0.01
+
+typedef struct linux_clock
+{
+    /** false falls back to CLOCK_MONOTONIC nanoseconds as ticks */
+    b8 is_tsc;
+    f64 seconds_per_tick;
+    f64 ns_per_tick;
+    /** a tick count and the monotonic time it was read at, absolute times are measured from here */
+    u64 anchor_ticks;
+    f64 anchor_seconds;
+} linux_clock;
+
+static linux_clock clock_state;
+static pthread_once_t clock_once = PTHREAD_ONCE_INIT;
+
+static u64 linux_clock_get_monotonic_ns()
 {
     struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
-    return now.tv_sec + now.tv_nsec * 0.000000001;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64)now.tv_sec * 1000000000ull + (u64)now.tv_nsec;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * The CPU has to promise a constant rate across frequency and sleep states, and the kernel has to still
+ * trust it: it switches its own clocksource away from the TSC once it sees it drift, e.g. on some VMs.
+ */
+static b8 linux_clock_is_tsc_usable()
+{
+    u32 eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+    {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    if ((edx & (1u << 8)) == 0)
+    {
+        return false;
+    }
+
+    FILE* file = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+    if (file == nullptr)
+    {
+        return true;
+    }
+    char clocksource[32] = {};
+    b8 is_read = fgets(clocksource, sizeof(clocksource), file) != nullptr;
+    fclose(file);
+    return !is_read || strncmp(clocksource, "tsc", 3) == 0;
+}
+
+/** reads the monotonic clock between two TSC reads, retries to find the tightest pair */
+static u64 linux_clock_sample(u64* out_ns)
+{
+    u64 best_ticks = 0;
+    u64 best_window = ~0ull;
+    u32 cpu;
+    for (s32 attempt = 0; attempt < 8; ++attempt)
+    {
+        u64 ticks_before = __rdtsc();
+        u64 ns = linux_clock_get_monotonic_ns();
+        u64 ticks_after = __rdtscp(&cpu);
+        if (ticks_after - ticks_before < best_window)
+        {
+            best_window = ticks_after - ticks_before;
+            best_ticks = ticks_before + best_window / 2;
+            *out_ns = ns;
+        }
+    }
+    return best_ticks;
+}
+#endif
+
+static void linux_clock_setup()
+{
+    clock_state.is_tsc = false;
+    clock_state.seconds_per_tick = 0.000000001;
+    clock_state.ns_per_tick = 1.0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (linux_clock_is_tsc_usable())
+    {
+        u64 start_ns;
+        u64 start_ticks = linux_clock_sample(&start_ns);
+        platform_sleep(LINUX_CLOCK_CALIBRATION_SECONDS);
+        u64 end_ns;
+        u64 end_ticks = linux_clock_sample(&end_ns);
+
+        if (end_ticks > start_ticks && end_ns > start_ns)
+        {
+            clock_state.is_tsc = true;
+            clock_state.ns_per_tick = (f64)(end_ns - start_ns) / (f64)(end_ticks - start_ticks);
+            clock_state.seconds_per_tick = clock_state.ns_per_tick * 0.000000001;
+            clock_state.anchor_ticks = end_ticks;
+            clock_state.anchor_seconds = end_ns * 0.000000001;
+        }
+    }
+#endif
+}
+
+f64 platform_get_absolute_time()
+{
+    pthread_once(&clock_once, linux_clock_setup);
+    if (!clock_state.is_tsc)
+    {
+        return linux_clock_get_monotonic_ns() * 0.000000001;
+    }
+    return clock_state.anchor_seconds + (f64)(s64)(platform_get_ticks() - clock_state.anchor_ticks) * clock_state.seconds_per_tick;
+}
+
+u64 platform_get_ticks()
+{
+    pthread_once(&clock_once, linux_clock_setup);
+#if defined(__x86_64__) || defined(__i386__)
+    if (clock_state.is_tsc)
+    {
+        return __rdtsc();
+    }
+#endif
+    return linux_clock_get_monotonic_ns();
+}
+
+u64 platform_get_ticks_ordered()
+{
+    pthread_once(&clock_once, linux_clock_setup);
+#if defined(__x86_64__) || defined(__i386__)
+    if (clock_state.is_tsc)
+    {
+        u32 cpu;
+        return __rdtscp(&cpu);
+    }
+#endif
+    return linux_clock_get_monotonic_ns();
+}
+
+f64 platform_get_ticks_per_second()
+{
+    pthread_once(&clock_once, linux_clock_setup);
+    return 1.0 / clock_state.seconds_per_tick;
+}
+
+f64 platform_ticks_to_seconds(u64 ticks)
+{
+    pthread_once(&clock_once, linux_clock_setup);
+    return (f64)ticks * clock_state.seconds_per_tick;
+}
+
+u64 platform_ticks_to_ns(u64 ticks)
+{
+    pthread_once(&clock_once, linux_clock_setup);
+    return (u64)((f64)ticks * clock_state.ns_per_tick);
+}
+
+/**
+ * =================== PLATFORM PERFORMANCE COUNTERS ===================
+ */
+
+/** the counter group of one thread, closed when the thread exits */
+typedef struct linux_perf_counters
+{
+    s32 fds[PLATFORM_PERF_COUNTER_COUNT] = { -1, -1, -1, -1, -1 };
+    b8 is_opened;
+    b8 is_failed;
+
+    ~linux_perf_counters();
+} linux_perf_counters;
+
+/** read format of the group: count, time enabled, time running, then one value per counter */
+typedef struct linux_perf_group_read
+{
+    u64 counter_count;
+    u64 time_enabled;
+    u64 time_running;
+    u64 values[PLATFORM_PERF_COUNTER_COUNT];
+} linux_perf_group_read;
+
+static thread_local linux_perf_counters perf_counters;
+/** only the first thread that fails says so, the reason is the same for all of them */
+static b8 is_perf_failure_logged;
+
+linux_perf_counters::~linux_perf_counters()
+{
+    for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+    {
+        if (fds[counter] >= 0)
+        {
+            close(fds[counter]);
+        }
+    }
+}
+
+static u64 linux_perf_cache_config(u64 cache, u64 operation, u64 result)
+{
+    return cache | (operation << 8) | (result << 16);
+}
+
+static b8 linux_perf_counters_open(linux_perf_counters* counters)
+{
+    struct
+    {
+        u32 type;
+        u64 config;
+    } events[PLATFORM_PERF_COUNTER_COUNT] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, linux_perf_cache_config(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+    };
+
+    for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+    {
+        struct perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = events[counter].type;
+        attr.config = events[counter].config;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        /** the cycles counter leads the group, the others follow it */
+        s32 group_fd = (counter == 0) ? -1 : counters->fds[0];
+        counters->fds[counter] = (s32)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+        if (counters->fds[counter] < 0)
+        {
+            if (!__atomic_exchange_n(&is_perf_failure_logged, true, __ATOMIC_RELAXED))
+            {
+                WWARNING("perf_event_open failed (%s), hardware counters are unavailable.", strerror(errno));
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+b8 platform_perf_counters_read(platform_perf_counters* out_counters)
+{
+    if (!perf_counters.is_opened)
+    {
+        if (perf_counters.is_failed)
+        {
+            return false;
+        }
+        perf_counters.is_opened = linux_perf_counters_open(&perf_counters);
+        perf_counters.is_failed = !perf_counters.is_opened;
+        if (perf_counters.is_failed)
+        {
+            return false;
+        }
+    }
+
+    linux_perf_group_read group = {};
+    if (read(perf_counters.fds[0], &group, sizeof(group)) != (ssize_t)sizeof(group) || group.time_running == 0)
+    {
+        return false;
+    }
+
+    /** the group was only scheduled part of the time if other users took the PMU, extrapolate to the whole time */
+    f64 scale = (f64)group.time_enabled / (f64)group.time_running;
+    for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+    {
+        out_counters->values[counter] = (group.time_running == group.time_enabled)
+            ? group.values[counter] : (u64)(group.values[counter] * scale);
+    }
+    return true;
 }
 
 /**
  * =================== PLATFORM THREADING ===================
  */
 
+void platform_sleep(f64 seconds)
+{
+    s64 duration_ns = (s64)(seconds * 1000000000.0);
+    struct timespec duration;
+    duration.tv_sec = duration_ns / 1000000000;
+    duration.tv_nsec = duration_ns % 1000000000;
+    while (nanosleep(&duration, &duration) == -1 && errno == EINTR)
+    {
+    }
+}
+
+void platform_address_wait(u32* address, u32 expected, f64 timeout_seconds)
+{
+    struct timespec timeout;
+    struct timespec* timeout_ptr = nullptr;
+    if (timeout_seconds >= 0.0)
+    {
+        s64 timeout_ns = (s64)(timeout_seconds * 1000000000.0);
+        timeout.tv_sec = timeout_ns / 1000000000;
+        timeout.tv_nsec = timeout_ns % 1000000000;
+        timeout_ptr = &timeout;
+    }
+    // returns right away if the value already changed, EINTR and timeouts are left to the caller's loop
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout_ptr, nullptr, 0);
+}
+
+void platform_address_wake(u32* address)
+{
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+void platform_sleep_until(f64 absolute_time)
+{
+    /**
+     * the absolute time only matches CLOCK_MONOTONIC at the calibration instant, the calibration error grows 
+     * with uptime, so the deadline is converted with a fresh reading of both clocks. Sleeping to an absolute 
+     * deadline keeps interrupted sleeps from adding up. */
+    f64 remaining_seconds = absolute_time - platform_get_absolute_time();
+    if (remaining_seconds <= 0.0)
+    {
+        return;
+    }
+    s64 deadline_ns = (s64)linux_clock_get_monotonic_ns() + (s64)(remaining_seconds * 1000000000.0);
+    struct timespec deadline;
+    deadline.tv_sec = deadline_ns / 1000000000;
+    deadline.tv_nsec = deadline_ns % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+    {
+    }
+}
+
 static void* platform_thread_main_routine(void* args)
 {
     thread_handle* handle = (thread_handle *)args;
     thread_context* thread_context = &state.thread_contexts[handle->ticket];
     platform_threading_job* job = (platform_threading_job *)&thread_context->jobs.data[handle->thread_idx]; 
 
+    current_thread_ticket = handle->ticket;
     if (job != nullptr && job->function != nullptr)
     {
         job->function(job->arg);
-        if (job->arg)
-        {
-            platform_memory_free(job->arg);
-            job->arg = nullptr;
-        }
     }
+    current_thread_ticket = -1;
 
     pthread_mutex_lock(&thread_context->mutex);
     thread_context->active_thread_count--;
     if (thread_context->active_thread_count == 0)
     {
-        dynarray_destroy(&thread_context->jobs);
-        state.thread_ticket_free_list[handle->ticket] = true;
-        dynarray_destroy(&thread_context->handles);
+        pthread_cond_broadcast(&thread_context->finished);
     }
     pthread_mutex_unlock(&thread_context->mutex);
     return nullptr;
 }
 
-void platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket)
+/** joins the finished threads of a ticket and hands the ticket back to the free list */
+static void platform_threadpool_release(thread_ticket ticket)
+{
+    thread_context* thread_context = &state.thread_contexts[ticket];
+    for (s32 thread_idx = 0; thread_idx < thread_context->threads.size; ++thread_idx)
+    {
+        pthread_join(thread_context->threads.data[thread_idx], nullptr);
+    }
+
+    dynarray_destroy(&thread_context->threads);
+    dynarray_destroy(&thread_context->jobs);
+    dynarray_destroy(&thread_context->handles);
+    arena_reset(&thread_context->arena);
+
+    pthread_mutex_lock(&state.mutex);
+    state.thread_ticket_in_use[ticket] = false;
+    pthread_mutex_unlock(&state.mutex);
+}
+
+/** 
+ * waits until every job of the ticket finished or `timeout_seconds` passed, 
+ * a negative timeout waits indefinitely 
+ */
+static b8 platform_threadpool_wait_internal(thread_context* thread_context, f64 timeout_seconds)
+{
+    struct timespec deadline;
+    if (timeout_seconds >= 0.0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        s64 timeout_ns = (s64)(timeout_seconds * 1000000000.0);
+        deadline.tv_sec += timeout_ns / 1000000000;
+        deadline.tv_nsec += timeout_ns % 1000000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    pthread_mutex_lock(&thread_context->mutex);
+    while (thread_context->active_thread_count > 0)
+    {
+        if (timeout_seconds < 0.0)
+        {
+            pthread_cond_wait(&thread_context->finished, &thread_context->mutex);
+        }
+        else if (pthread_cond_timedwait(&thread_context->finished, &thread_context->mutex, &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+    b8 is_finished = thread_context->active_thread_count == 0;
+    pthread_mutex_unlock(&thread_context->mutex);
+
+    return is_finished;
+}
+
+static s64 platform_threadpool_align(s64 size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(s64)(ARENA_ALIGNMENT - 1);
+}
+
+b8 platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket)
 {
     pthread_mutex_lock(&state.mutex);
     b8 found = false;
     thread_ticket ticket_idx;
     for (ticket_idx = 0; ticket_idx < 64; ++ticket_idx)
     {
-        if (state.thread_ticket_free_list[ticket_idx] == true)
+        if (state.thread_ticket_in_use[ticket_idx] == false)
         {
-            state.thread_ticket_free_list[ticket_idx] = false;
+            state.thread_ticket_in_use[ticket_idx] = true;
             found = true;
             break;
         }
     }
     if (found == false)
     {
-        return;
+        pthread_mutex_unlock(&state.mutex);
+        WERROR("No free thread ticket left.\n");
+        return false;
     }
 
     *out_ticket = ticket_idx;
 
     thread_context* thread_context = &state.thread_contexts[ticket_idx];
-    if (thread_context->threads.data == nullptr)
+    if (!thread_context->is_initialized)
+    {
+        /** timed waits are measured against the monotonic clock */
+        pthread_condattr_t condattr;
+        pthread_condattr_init(&condattr);
+        pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+        pthread_cond_init(&thread_context->finished, &condattr);
+        pthread_condattr_destroy(&condattr);
+        thread_context->is_initialized = true;
+    }
+
+    /** everything the batch needs comes from the ticket's arena, so adding jobs does not touch the heap */
+    s64 required_size = platform_threadpool_align(sizeof(pthread_t) * chunk_count) +
+                        platform_threadpool_align(sizeof(platform_threading_job) * chunk_count) +
+                        platform_threadpool_align(sizeof(thread_handle) * chunk_count) +
+                        platform_threadpool_align(jobs->arg_size * chunk_count);
+    if (thread_context->arena.capacity < required_size)
+    {
+        s64 arena_size = (thread_context->arena.capacity > 0) ? thread_context->arena.capacity : PLATFORM_THREADPOOL_ARENA_SIZE;
+        while (arena_size < required_size)
+        {
+            arena_size *= 2;
+        }
+        arena_destroy(&thread_context->arena);
+        if (!arena_create(&thread_context->arena, arena_size, MEMORY_TAG_THREADING))
+        {
+            state.thread_ticket_in_use[ticket_idx] = false;
+            pthread_mutex_unlock(&state.mutex);
+            return false;
+        }
+    }
+
+    allocator ticket_allocator = arena_allocator(&thread_context->arena);
+    thread_context->threads = dynarray_create<pthread_t>(chunk_count, ticket_allocator);
+    thread_context->jobs = dynarray_create<platform_threading_job>(chunk_count, ticket_allocator);
+    thread_context->handles = dynarray_create<thread_handle>(chunk_count, ticket_allocator);
+    u8* args = (u8 *)arena_alloc(&thread_context->arena, jobs->arg_size * chunk_count);
+    if (jobs->arg_size > 0)
     {
-        thread_context->threads = dynarray_create<pthread_t>(chunk_count);
+        platform_memory_copy(args, jobs->arg, jobs->arg_size * chunk_count);
     }
-    dynarray_clear(&thread_context->threads);
-    thread_context->jobs = dynarray_create<platform_threading_job>(chunk_count);
-    thread_context->handles = dynarray_create<thread_handle>(chunk_count);
     thread_context->active_thread_count = chunk_count;
+    __atomic_store_n(&thread_context->is_cancelled, false, __ATOMIC_RELAXED);
     
     for (s32 job_idx = 0; job_idx < chunk_count; ++job_idx)
     {
         platform_threading_job job = {};
         job.function = jobs->function;
         job.arg_size = jobs->arg_size;
-        job.arg = platform_memory_alloc(jobs->arg_size);
-        platform_memory_copy(job.arg, ((u8 *)jobs->arg) + jobs->arg_size * job_idx, jobs->arg_size);
+        job.arg = (jobs->arg_size > 0) ? args + jobs->arg_size * job_idx : nullptr;
        
         thread_context->threads.data[job_idx] = {};
         thread_context->jobs.data[job_idx] = job;
@@ -777,15 +1576,63 @@ void platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thre
                 &thread_context->handles.data[job_idx]);
     }
     pthread_mutex_unlock(&state.mutex);
+    return true;
 }
  
-void platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time)
+b8 platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time)
 {
     thread_context* thread_context = &state.thread_contexts[ticket];
-    for (s32 thread_idx = 0; thread_idx < thread_context->threads.size; ++thread_idx)
+
+    b8 is_finished;
+    if (cancellation_time <= 0.0)
     {
-        pthread_join(thread_context->threads.data[thread_idx], nullptr);
+        is_finished = platform_threadpool_wait_internal(thread_context, -1.0);
+    }
+    else
+    {
+        f64 remaining_seconds = cancellation_time - platform_get_absolute_time();
+        is_finished = platform_threadpool_wait_internal(thread_context, remaining_seconds > 0.0 ? remaining_seconds : 0.0);
+        if (!is_finished)
+        {
+            /** the jobs poll the flag, the remaining wait is bounded by their polling interval */
+            platform_threadpool_cancel(ticket);
+        }
+    }
+
+    platform_threadpool_release(ticket);
+    return is_finished;
+}
+
+b8 platform_threadpool_wait(thread_ticket ticket, f64 timeout_seconds)
+{
+    thread_context* thread_context = &state.thread_contexts[ticket];
+    if (!platform_threadpool_wait_internal(thread_context, timeout_seconds > 0.0 ? timeout_seconds : 0.0))
+    {
+        return false;
     }
+
+    platform_threadpool_release(ticket);
+    return true;
+}
+
+b8 platform_threadpool_try_wait(thread_ticket ticket)
+{
+    return platform_threadpool_wait(ticket, 0.0);
+}
+
+void platform_threadpool_cancel(thread_ticket ticket)
+{
+    __atomic_store_n(&state.thread_contexts[ticket].is_cancelled, true, __ATOMIC_RELAXED);
+}
+
+b8 platform_threadpool_is_cancelled()
+{
+    if (current_thread_ticket < 0)
+    {
+        return false;
+    }
+
+    return __atomic_load_n(&state.thread_contexts[current_thread_ticket].is_cancelled, __ATOMIC_RELAXED);
 }
 
 /**
@@ -812,6 +1659,76 @@ void platform_register_mouse_wheel_event(platform_mouse_wheel_event_t callback)
     state.mouse_wheel_event = callback;
 }
 
+void platform_register_window_state_event(platform_window_state_event_t callback)
+{
+    state.window_state_event = callback;
+}
+
+void platform_register_window_close_event(platform_window_close_event_t callback)
+{
+    state.window_close_event = callback;
+}
+
+b8 platform_wait_for_events(f64 timeout_seconds)
+{
+    if (state.is_headless)
+    {
+        return platform_headless_wait_for_events(timeout_seconds);
+    }
+
+    s32 timeout_ms = (timeout_seconds >= 0.0) ? (s32)(timeout_seconds * 1000.0) : -1;
+    s32 result;
+    if (state.is_input_thread_running)
+    {
+        /** the input thread owns the connection, it signals the eventfd once it queued events */
+        struct pollfd wake_fd = {};
+        wake_fd.fd = state.input_wake_fd;
+        wake_fd.events = POLLIN;
+        while ((result = poll(&wake_fd, 1, timeout_ms)) == -1 && errno == EINTR)
+        {
+        }
+
+        u64 wake_count;
+        [[maybe_unused]] ssize_t _ = read(state.input_wake_fd, &wake_count, sizeof(wake_count));
+        return result > 0;
+    }
+
+    /** requests still buffered would never get the replies and events the wait is for */
+    xcb_flush(state.handle.connection);
+
+    struct pollfd connection_fd = {};
+    connection_fd.fd = xcb_get_file_descriptor(state.handle.connection);
+    connection_fd.events = POLLIN;
+    while ((result = poll(&connection_fd, 1, timeout_ms)) == -1 && errno == EINTR)
+    {
+    }
+    return result > 0;
+}
+
+
+static b8 translate_mouse_button(u8 button, mouse_button* out_mouse_button)
+{
+    switch (button)
+    {
+        case PLATFORM_MOUSE_BUTTON_LEFT: *out_mouse_button = MOUSE_BUTTON_LEFT; return true;
+        case PLATFORM_MOUSE_BUTTON_MIDDLE: *out_mouse_button = MOUSE_BUTTON_MIDDLE; return true;
+        case PLATFORM_MOUSE_BUTTON_RIGHT: *out_mouse_button = MOUSE_BUTTON_RIGHT; return true;
+        case PLATFORM_MOUSE_BUTTON_1: *out_mouse_button = MOUSE_BUTTON_1; return true;
+        case PLATFORM_MOUSE_BUTTON_2: *out_mouse_button = MOUSE_BUTTON_2; return true;
+        case PLATFORM_MOUSE_BUTTON_3: *out_mouse_button = MOUSE_BUTTON_3; return true;
+        case PLATFORM_MOUSE_BUTTON_4: *out_mouse_button = MOUSE_BUTTON_4; return true;
+        case PLATFORM_MOUSE_BUTTON_5: *out_mouse_button = MOUSE_BUTTON_5; return true;
+        case PLATFORM_MOUSE_BUTTON_6: *out_mouse_button = MOUSE_BUTTON_6; return true;
+        case PLATFORM_MOUSE_BUTTON_7: *out_mouse_button = MOUSE_BUTTON_7; return true;
+        case PLATFORM_MOUSE_BUTTON_8: *out_mouse_button = MOUSE_BUTTON_8; return true;
+        case PLATFORM_MOUSE_BUTTON_9: *out_mouse_button = MOUSE_BUTTON_9; return true;
+        case PLATFORM_MOUSE_WHEEL_LEFT: *out_mouse_button = MOUSE_WHEEL_LEFT; return true;
+        case PLATFORM_MOUSE_WHEEL_RIGHT: *out_mouse_button = MOUSE_WHEEL_RIGHT; return true;
+    }
+
+    return false;
+}
+
 static keycode translate_keycode(const unsigned int key_code)
 {
     switch (key_code)
@@ -3,6 +3,7 @@
 
 #include "warpunk.core/src/utils/logger.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/platform/platform_headless.h"
 
 #include <string.h>
 
@@ -27,15 +28,19 @@ static void win32_clock_setup(void)
     min_period = tc.wPeriodMin;
 }
 
-bool platform_startup()
+bool platform_startup(platform_config config)
 {
     win32_clock_setup();
 
-    return true;
+    // TODO: window, until then every backend is the virtual window
+    s16 window_width = (config.window_width > 0) ? config.window_width : 960;
+    s16 window_height = (config.window_height > 0) ? config.window_height : 540;
+    return platform_headless_startup(true, window_width, window_height);
 }
 
 void platform_shutdown()
 {
+    platform_headless_shutdown();
 }
 
 
@@ -95,6 +100,11 @@ void platform_memory_free(void* src)
     HeapFree(GetProcessHeap(), 0, src);
 }
 
+void* platform_memory_realloc(void* src, s64 size)
+{
+    return (void*)HeapReAlloc(GetProcessHeap(), 0, src, size);
+}
+
 void platform_memory_copy(void* dst, void* src, s64 size)
 {
     memcpy(dst, src, size);
@@ -110,6 +120,77 @@ void platform_memory_zero(void* dst, s64 size)
     memset(dst, 0, size);
 }
 
+b8 platform_mapped_file_create(const char* path, s64 size, platform_mapped_file* out_file)
+{
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    // the mapping grows the file to its size
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, NULL);
+    void* memory = (mapping != NULL) ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : NULL;
+    if (mapping != NULL)
+    {
+        CloseHandle(mapping);
+    }
+    if (memory == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    out_file->memory = memory;
+    out_file->size = size;
+    out_file->handle = (s64)file;
+    return true;
+}
+
+void platform_mapped_file_sync(platform_mapped_file* file)
+{
+    FlushViewOfFile(file->memory, file->size);
+    FlushFileBuffers((HANDLE)file->handle);
+}
+
+void platform_mapped_file_close(platform_mapped_file* file, s64 used_size)
+{
+    UnmapViewOfFile(file->memory);
+    LARGE_INTEGER end;
+    end.QuadPart = used_size;
+    SetFilePointerEx((HANDLE)file->handle, end, NULL, FILE_BEGIN);
+    SetEndOfFile((HANDLE)file->handle);
+    CloseHandle((HANDLE)file->handle);
+    *file = {};
+}
+
+b8 platform_file_rename(const char* path, const char* new_path)
+{
+    return MoveFileExA(path, new_path, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+b8 platform_file_delete(const char* path)
+{
+    return DeleteFileA(path) != 0;
+}
+
+static platform_crash_handler_t crash_handler;
+
+static LONG WINAPI platform_crash_exception_filter(EXCEPTION_POINTERS* exception)
+{
+    if (crash_handler != nullptr)
+    {
+        crash_handler((s32)exception->ExceptionRecord->ExceptionCode);
+    }
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+void platform_register_crash_handler(platform_crash_handler_t handler)
+{
+    crash_handler = handler;
+    SetUnhandledExceptionFilter(handler != nullptr ? platform_crash_exception_filter : NULL);
+}
+
 void platform_console_write(log_level level, const char* message)
 {
     b8 is_error = (level == LOG_LEVEL_ERROR || level == LOG_LEVEL_FATAL);
@@ -151,12 +232,100 @@ f64 platform_get_absolute_time()
     return (f64)now_time.QuadPart * clock_frequency;
 }
 
-void platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket)
+/** QueryPerformanceCounter already reads the invariant TSC where Windows trusts it, it is the tick counter */
+u64 platform_get_ticks()
 {
+    LARGE_INTEGER now_time;
+    QueryPerformanceCounter(&now_time);
+    return (u64)now_time.QuadPart;
 }
 
-void platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time)
+u64 platform_get_ticks_ordered()
 {
+    return platform_get_ticks();
+}
+
+f64 platform_get_ticks_per_second()
+{
+    if (!clock_frequency)
+    {
+        win32_clock_setup();
+    }
+    return 1.0 / clock_frequency;
+}
+
+f64 platform_ticks_to_seconds(u64 ticks)
+{
+    if (!clock_frequency)
+    {
+        win32_clock_setup();
+    }
+    return (f64)ticks * clock_frequency;
+}
+
+u64 platform_ticks_to_ns(u64 ticks)
+{
+    return (u64)(platform_ticks_to_seconds(ticks) * 1000000000.0);
+}
+
+b8 platform_perf_counters_read(platform_perf_counters* out_counters)
+{
+    // TODO: hardware counters need a kernel driver on Windows
+    return false;
+}
+
+void platform_sleep(f64 seconds)
+{
+    Sleep((DWORD)(seconds * 1000.0));
+}
+
+void platform_sleep_until(f64 absolute_time)
+{
+    f64 remaining_seconds = absolute_time - platform_get_absolute_time();
+    if (remaining_seconds > 0.0)
+    {
+        platform_sleep(remaining_seconds);
+    }
+}
+
+void platform_address_wait(u32* address, u32 expected, f64 timeout_seconds)
+{
+    DWORD timeout_ms = (timeout_seconds >= 0.0) ? (DWORD)(timeout_seconds * 1000.0) : INFINITE;
+    WaitOnAddress(address, &expected, sizeof(expected), timeout_ms);
+}
+
+void platform_address_wake(u32* address)
+{
+    WakeByAddressAll(address);
+}
+
+b8 platform_threadpool_add(platform_threading_job* jobs, u32 chunk_count, thread_ticket* out_ticket)
+{
+    return false;
+}
+
+b8 platform_threadpool_sync(thread_ticket ticket, f64 cancellation_time)
+{
+    return true;
+}
+
+b8 platform_threadpool_wait(thread_ticket ticket, f64 timeout_seconds)
+{
+    return true;
+}
+
+b8 platform_threadpool_try_wait(thread_ticket ticket)
+{
+    return true;
+}
+
+void platform_threadpool_cancel(thread_ticket ticket)
+{
+}
+
+b8 platform_threadpool_is_cancelled()
+{
+    return false;
 }
 
 void platform_register_keyboard_event(platform_keyboard_event_t callback)
@@ -175,4 +344,28 @@ void platform_register_mouse_wheel_event(platform_mouse_wheel_event_t callback)
 {
 }
 
+void platform_register_window_state_event(platform_window_state_event_t callback)
+{
+}
+
+void platform_register_window_close_event(platform_window_close_event_t callback)
+{
+}
+
+b8 platform_wait_for_events(f64 timeout_seconds)
+{
+    if (platform_is_headless())
+    {
+        return platform_headless_wait_for_events(timeout_seconds);
+    }
+
+    DWORD timeout_ms = (timeout_seconds >= 0.0) ? (DWORD)(timeout_seconds * 1000.0) : INFINITE;
+    return MsgWaitForMultipleObjects(0, NULL, FALSE, timeout_ms, QS_ALLINPUT) == WAIT_OBJECT_0;
+}
+
+u64 platform_get_oldest_event_ticks()
+{
+    return 0;
+}
+
 #endif
\ No newline at end of file
@@ -7,14 +7,18 @@
 #include "warpunk.core/src/renderer/materials/material.hpp"
 
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/container/slotmap.hpp"
+#include "warpunk.core/src/utils/profiler.h"
 
 #define BYTES_PER_PIXEL 4
+#define CAMERA_MAX_COUNT 64
 
 struct camera
 {
    /** ratio of image width over height */
     f64 aspect_ratio;
     f64 focal_length;
+    f64 viewport_height;
     /** count of random samples for each pixel */
     s32 samples_per_pixel;
     /** color scale factor for a sum of pixel samples */
@@ -32,54 +36,125 @@ struct camera
     v3f64 pixel_delta_u; 
     /** offset to pixel below */
     v3f64 pixel_delta_v;
+
+    /** reseed the random stream per sample, independent of thread scheduling */
+    b8 deterministic;
+    u64 seed;
+
+    /** rays traced since the last camera_reset_ray_count */
+    u64 ray_count;
 };
 
-// TODO: Dynamic container!
-static camera_handle camera_count = 0;
-static camera cameras[10];
+/** created on the first camera_create, handles are slotmap handles */
+static slotmap<camera> cameras;
 
-camera_handle camera_create(camera_config camera_config)
+/** @returns nullptr and logs if the handle was destroyed or never created */
+static camera* camera_get(camera_handle camera_handle)
 {
-    p3f64 center = { 0, 0, 0 };
-    f64 aspect_ratio = camera_config.aspect_ratio;
-    s32 image_height = (s32)((f64)camera_config.image_width / aspect_ratio);
-    image_height = (image_height < 1) ? 1 : image_height;
+    camera* camera = slotmap_get(&cameras, camera_handle);
+    if (camera == nullptr)
+    {
+        WERROR("Invalid camera handle 0x%08x", camera_handle);
+    }
+    return camera;
+}
+
+/** recomputes image height and viewport vectors from the current image width */
+static void camera_update_viewport(camera* camera)
+{
+    camera->center = { 0, 0, 0 };
+    camera->image_height = (s32)((f64)camera->image_width / camera->aspect_ratio);
+    camera->image_height = (camera->image_height < 1) ? 1 : camera->image_height;
 
     /** determine viewport dimensions */
-    f64 viewport_height = camera_config.viewport_height;
-    f64 viewport_width = viewport_height * ((f64)camera_config.image_width) / image_height;
+    f64 viewport_height = camera->viewport_height;
+    f64 viewport_width = viewport_height * ((f64)camera->image_width) / camera->image_height;
     
     /** calculate the vectors across the horizontal and down the vertical viewport edges */
     v3f64 viewport_u = { viewport_width, 0, 0 };
     v3f64 viewport_v = { 0, -viewport_height, 0 };
 
     /** calculate the horizontal and vertical delta vectors from pixel to pixel */
-    v3f64 pixel_delta_u = viewport_u / camera_config.image_width;
-    v3f64 pixel_delta_v = viewport_v / image_height;
+    camera->pixel_delta_u = viewport_u / camera->image_width;
+    camera->pixel_delta_v = viewport_v / camera->image_height;
 
     /** calculate the location of the upper left pixel */
-    v3f64 z = { 0, 0, camera_config.focal_length };
-    v3f64 viewport_upper_left = center - z - (viewport_u / 2) - (viewport_v / 2);
-    p3f64 pixel00_loc = viewport_upper_left + 0.5 * (pixel_delta_u + pixel_delta_v);
+    v3f64 z = { 0, 0, camera->focal_length };
+    v3f64 viewport_upper_left = camera->center - z - (viewport_u / 2) - (viewport_v / 2);
+    camera->pixel00_loc = viewport_upper_left + 0.5 * (camera->pixel_delta_u + camera->pixel_delta_v);
+}
 
-    camera_handle camera_handle = camera_count;
-    cameras[camera_count++] = {
-        .aspect_ratio = aspect_ratio,
+camera_handle camera_create(camera_config camera_config)
+{
+    if (cameras.capacity == 0)
+    {
+        cameras = slotmap_create<camera>(CAMERA_MAX_COUNT, allocator_heap(MEMORY_TAG_RENDERER));
+    }
+
+    camera camera = {
+        .aspect_ratio = camera_config.aspect_ratio,
         .focal_length = camera_config.focal_length,
+        .viewport_height = camera_config.viewport_height,
         .samples_per_pixel = camera_config.samples_per_pixel,
         .pixel_samples_scale = 1.0 / camera_config.samples_per_pixel,
         .max_depth = camera_config.max_depth,
         .image_width = camera_config.image_width,
-        .image_height = image_height,
-        .center = center,
-        .pixel00_loc = pixel00_loc,
-        .pixel_delta_u = pixel_delta_u,
-        .pixel_delta_v = pixel_delta_v,
+        .deterministic = camera_config.deterministic,
+        .seed = camera_config.seed,
     };
-    
+    camera_update_viewport(&camera);
+
+    camera_handle camera_handle = slotmap_insert(&cameras, camera);
+    if (camera_handle == SLOTMAP_INVALID_HANDLE)
+    {
+        WERROR("No free camera left, at most %d can exist at a time", CAMERA_MAX_COUNT);
+    }
     return camera_handle;
 }
 
+void camera_destroy(camera_handle camera_handle)
+{
+    if (!slotmap_remove(&cameras, camera_handle))
+    {
+        WERROR("Invalid camera handle 0x%08x", camera_handle);
+    }
+}
+
+void camera_resize(camera_handle camera_handle, s32 image_width)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return;
+    }
+    camera->image_width = (image_width < 1) ? 1 : image_width;
+    camera_update_viewport(camera);
+}
+
+void camera_set_samples_per_pixel(camera_handle camera_handle, s32 samples_per_pixel)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return;
+    }
+    camera->samples_per_pixel = (samples_per_pixel < 1) ? 1 : samples_per_pixel;
+    camera->pixel_samples_scale = 1.0 / camera->samples_per_pixel;
+}
+
+void camera_get_image_size(camera_handle camera_handle, s32* out_width, s32* out_height)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        *out_width = 0;
+        *out_height = 0;
+        return;
+    }
+    *out_width = camera->image_width;
+    *out_height = camera->image_height;
+}
+
 inline f64 linear_to_gamma(f64 linear_component)
 {
     if (linear_component > 0)
@@ -111,13 +186,11 @@ inline v3<T> sample_square()
 }
 
 template<typename T>
-inline ray<T> get_ray(camera_handle camera_handle, s32 x, s32 y)
+inline ray<T> get_ray(const camera* camera, s32 x, s32 y)
 {
     /** 
      * construct a camera ray originating from the origin and directed at randomly sampled
      * point around the pixel location x, y */
-    camera* camera = &cameras[camera_handle];
-
     v3<T> offset = sample_square<T>();
     v3<T> pixel_sample = camera->pixel00_loc 
                          + ((x + offset.x) * camera->pixel_delta_u) 
@@ -135,7 +208,7 @@ inline ray<T> get_ray(camera_handle camera_handle, s32 x, s32 y)
 }
 
 template<typename T>
-v3f64 ray_color(ray<T>* r, sphere<T>* spheres, s32 depth)
+v3f64 ray_color(ray<T>* r, sphere<T>* spheres, s32 sphere_count, s32 depth, u64* ray_count)
 {
     if (depth <= 0)
     {
@@ -144,15 +217,19 @@ v3f64 ray_color(ray<T>* r, sphere<T>* spheres, s32 depth)
                          .b = 0.0 };
     }
 
+    ++*ray_count;
+
+    /** closest hit, every hit shrinks the search interval */
     hit_record<T> record = {};
     bool hit_sphere = false;
-    for (int sphere_idx = 0; sphere_idx < 4; ++sphere_idx)
+    interval<T> ray_interval = { 0.001, inf64 };
+    for (int sphere_idx = 0; sphere_idx < sphere_count; ++sphere_idx)
     {
         sphere<f64>* sphere = &spheres[sphere_idx];
-        if (hit(sphere, r, { 0.001, inf64 }, &record))
+        if (hit(sphere, r, ray_interval, &record))
         {
             hit_sphere = true;
-            break;
+            ray_interval.max = record.t;
         }
     }
 
@@ -162,7 +239,7 @@ v3f64 ray_color(ray<T>* r, sphere<T>* spheres, s32 depth)
         v3<T> attenuation = zero<T>();
         if (scatter(record.material, r, &record, &attenuation, &scattered))
         {
-            return attenuation * ray_color(&scattered, spheres, depth-1); 
+            return attenuation * ray_color(&scattered, spheres, sphere_count, depth-1, ray_count); 
         }
         return v3f64 { 0.0, 0.0, 0.0 };
     }
@@ -174,10 +251,42 @@ v3f64 ray_color(ray<T>* r, sphere<T>* spheres, s32 depth)
  
 }
 
+rayf64 camera_get_ray(camera_handle camera_handle, s32 x, s32 y)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return rayf64 {};
+    }
+    return get_ray<f64>(camera, x, y);
+}
+
+u64 camera_get_ray_count(camera_handle camera_handle)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return 0;
+    }
+    return __atomic_load_n(&camera->ray_count, __ATOMIC_RELAXED);
+}
+
+void camera_reset_ray_count(camera_handle camera_handle)
+{
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return;
+    }
+    __atomic_store_n(&camera->ray_count, 0, __ATOMIC_RELAXED);
+}
+
 typedef struct render_chunk
 {
-    camera_handle camera_handle;
+    /** resolved once per frame, the camera must not be destroyed while it renders */
+    camera* camera;
     void* objects;
+    s32 object_count;
     u8* out_buffer;
     u16 x_start;
     u16 y_start;
@@ -187,11 +296,14 @@ typedef struct render_chunk
 
 void camera_ray_cast_chunk(void* data)
 {
+    WPROFILE_SCOPE("tile");
+
     render_chunk* chunk = (render_chunk *)data;
 
     sphere<f64>* spheres = (sphere<f64> *)chunk->objects;
     u8* row = chunk->out_buffer;
-    camera* camera = &cameras[chunk->camera_handle];
+    camera* camera = chunk->camera;
+    u64 ray_count = 0;
 
     for (u16 y = chunk->y_start; y < chunk->height; ++y)
     {
@@ -199,30 +311,63 @@ void camera_ray_cast_chunk(void* data)
         for (u16 x = chunk->x_start; x < chunk->width; ++x)
         {
             v3f64 unit_color = zero<f64>();
-            for (int sample = 0; sample < camera->samples_per_pixel; ++sample)
+            s32 sample = 0;
+            u64 pixel_seed = random_hash(camera->seed, (u64)y * camera->image_width + x);
+            for (; sample < camera->samples_per_pixel; ++sample)
             {
-                rayf64 ray = get_ray<f64>(chunk->camera_handle, x, y);
-                unit_color += ray_color<f64>(&ray, spheres, camera->max_depth);
+                if (platform_threadpool_is_cancelled())
+                {
+                    break;
+                }
+
+                if (camera->deterministic)
+                {
+                    random_seed(random_hash(pixel_seed, sample));
+                }
+
+                rayf64 ray = get_ray<f64>(camera, x, y);
+                unit_color += ray_color<f64>(&ray, spheres, chunk->object_count, camera->max_depth, &ray_count);
             }
 
-            v3<u8> color = get_color_from_unit(unit_color * camera->pixel_samples_scale);
-            
-            u8 alpha = 255;
-            *pixel++ =((((alpha << 24) | color.r << 16) | color.g << 8) | color.b);
+            /** 
+             * a cancelled pixel keeps the samples it already has, everything after it keeps 
+             * the previous frame's contents */
+            if (sample > 0)
+            {
+                v3<u8> color = get_color_from_unit(unit_color * (1.0 / sample));
+                
+                u8 alpha = 255;
+                *pixel =((((alpha << 24) | color.r << 16) | color.g << 8) | color.b);
+            }
+            ++pixel;
+
+            if (sample < camera->samples_per_pixel)
+            {
+                __atomic_add_fetch(&camera->ray_count, ray_count, __ATOMIC_RELAXED);
+                return;
+            }
         }
 
         row += camera->image_width * BYTES_PER_PIXEL;
     }
+
+    __atomic_add_fetch(&camera->ray_count, ray_count, __ATOMIC_RELAXED);
 }
 
-void camera_ray_cast(camera_handle camera_handle, void* objects, u8* out_buffer)
+camera_ray_cast_result camera_ray_cast(camera_handle camera_handle, void* objects, s32 object_count, u8* out_buffer, f64 deadline)
 {
-    camera* camera = &cameras[camera_handle];
+    WPROFILE_FUNCTION();
+
+    camera* camera = camera_get(camera_handle);
+    if (camera == nullptr)
+    {
+        return CAMERA_RAY_CAST_RESULT_FAILED;
+    }
 
     s32 chunk_width = camera->image_width / 4;
     s32 chunk_height = camera->image_height / 4;
 
-    render_chunk render_chunk[16];
+    render_chunk render_chunks[16];
     for (int y = 0; y < 4; ++y)
     {
         for (int x = 0; x < 4; ++x)
@@ -230,23 +375,32 @@ void camera_ray_cast(camera_handle camera_handle, void* objects, u8* out_buffer)
             int x_start = chunk_width * x;
             int y_start = chunk_height * y; 
 
+            /** the last row and column absorb the remainder of non multiple of 4 resolutions */
+            int x_end = (x == 3) ? camera->image_width : x_start + chunk_width;
+            int y_end = (y == 3) ? camera->image_height : y_start + chunk_height;
+
             int offset = x + y * 4;
-            render_chunk[offset].camera_handle = camera_handle;
-            render_chunk[offset].objects = objects;
-            render_chunk[offset].out_buffer = out_buffer + (x * chunk_width * BYTES_PER_PIXEL) + (y * chunk_height * camera->image_width * BYTES_PER_PIXEL);
-            render_chunk[offset].x_start = x_start;
-            render_chunk[offset].y_start = y_start;
-            render_chunk[offset].width = x_start + chunk_width;
-            render_chunk[offset].height = y_start + chunk_height;
+            render_chunks[offset].camera = camera;
+            render_chunks[offset].objects = objects;
+            render_chunks[offset].object_count = object_count;
+            render_chunks[offset].out_buffer = out_buffer + (x * chunk_width * BYTES_PER_PIXEL) + (y * chunk_height * camera->image_width * BYTES_PER_PIXEL);
+            render_chunks[offset].x_start = x_start;
+            render_chunks[offset].y_start = y_start;
+            render_chunks[offset].width = x_end;
+            render_chunks[offset].height = y_end;
         }
     }
 
     platform_threading_job job = {};
     job.function = camera_ray_cast_chunk;
-    job.arg = render_chunk;
+    job.arg = render_chunks;
     job.arg_size = sizeof(render_chunk);
 
     thread_ticket ticket;
-    platform_threadpool_add(&job, 16, &ticket);
-    platform_threadpool_sync(ticket, 0);
+    if (!platform_threadpool_add(&job, 16, &ticket))
+    {
+        WERROR("Failed to dispatch the ray cast tiles.");
+        return CAMERA_RAY_CAST_RESULT_FAILED;
+    }
+    return platform_threadpool_sync(ticket, deadline) ? CAMERA_RAY_CAST_RESULT_COMPLETE : CAMERA_RAY_CAST_RESULT_CUT;
 }
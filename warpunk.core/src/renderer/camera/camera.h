@@ -1,6 +1,7 @@
 #pragma once
 
 #include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/math/ray.hpp"
 
 typedef struct camera_config
 {
@@ -10,11 +11,47 @@ typedef struct camera_config
     f64 viewport_height;
     s32 samples_per_pixel;
     s32 max_depth;
+    /** when set, the random stream of every sample depends only on pixel, sample and seed */
+    b8 deterministic;
+    u64 seed;
 } camera_config;
 
+typedef enum camera_ray_cast_result
+{
+    CAMERA_RAY_CAST_RESULT_COMPLETE,
+    /** the deadline stopped tiles early, they keep the pixels they did not get to */
+    CAMERA_RAY_CAST_RESULT_CUT,
+    /** nothing was traced, the handle is invalid or the tiles could not be dispatched */
+    CAMERA_RAY_CAST_RESULT_FAILED
+} camera_ray_cast_result;
+
+/** @returns a generational handle, 0 if the camera limit is reached. */
+warpunk_api camera_handle camera_create(camera_config camera_config);
+
+/** The handle and every copy of it become invalid, calls with them log an error and do nothing. */
+warpunk_api void camera_destroy(camera_handle camera_handle);
+
+/** Changes the rendered image width, the height follows from the aspect ratio. */
+warpunk_api void camera_resize(camera_handle camera_handle, s32 image_width);
+
 /** */
-camera_handle camera_create(camera_config camera_config);
+warpunk_api void camera_set_samples_per_pixel(camera_handle camera_handle, s32 samples_per_pixel);
 
 /** */
-void camera_ray_cast(camera_handle camera_handle, void* objects, u8* out_buffer);
+warpunk_api void camera_get_image_size(camera_handle camera_handle, s32* out_width, s32* out_height);
+
+/** Samples a primary ray through pixel x, y with a random offset inside the pixel. */
+warpunk_api rayf64 camera_get_ray(camera_handle camera_handle, s32 x, s32 y);
+
+/** Rays traced, including bounces, since the last reset. */
+warpunk_api u64 camera_get_ray_count(camera_handle camera_handle);
+
+/** */
+warpunk_api void camera_reset_ray_count(camera_handle camera_handle);
+
+/** 
+ * Renders `object_count` spheres into `out_buffer`. Tiles still tracing at `deadline` (platform_get_absolute_time
+ * clock, 0 for none) stop early and leave their remaining pixels untouched.
+ */
+warpunk_api camera_ray_cast_result camera_ray_cast(camera_handle camera_handle, void* objects, s32 object_count, u8* out_buffer, f64 deadline);
 
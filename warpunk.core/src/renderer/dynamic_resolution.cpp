@@ -0,0 +1,160 @@
+#include "warpunk.core/src/renderer/dynamic_resolution.h"
+
+#include "warpunk.core/src/math/math_common.hpp"
+
+#include <cmath>
+
+/** relative budget error that is tolerated before anything is changed */
+#define DYNAMIC_RESOLUTION_DEADBAND 0.1
+/** weight of the newest frame in the smoothed render time */
+#define DYNAMIC_RESOLUTION_SMOOTHING 0.25
+/** the scale moves in steps of 1/32 so the camera is not resized on every frame */
+#define DYNAMIC_RESOLUTION_SCALE_STEPS 32.0f
+
+void dynamic_resolution_init(dynamic_resolution* dynamic_resolution, dynamic_resolution_config config)
+{
+    if (config.min_samples_per_pixel < 1)
+    {
+        config.min_samples_per_pixel = 1;
+    }
+    if (config.max_samples_per_pixel < config.min_samples_per_pixel)
+    {
+        config.max_samples_per_pixel = config.min_samples_per_pixel;
+    }
+    if (config.min_scale <= 0.0f)
+    {
+        config.min_scale = 1.0f / DYNAMIC_RESOLUTION_SCALE_STEPS;
+    }
+    if (config.max_scale < config.min_scale)
+    {
+        config.max_scale = config.min_scale;
+    }
+
+    dynamic_resolution->config = config;
+    dynamic_resolution->scale = config.max_scale;
+    dynamic_resolution->samples_per_pixel = config.max_samples_per_pixel;
+    dynamic_resolution->smoothed_seconds = 0.0;
+}
+
+b8 dynamic_resolution_update(dynamic_resolution* dynamic_resolution, f64 frame_seconds)
+{
+    dynamic_resolution_config* config = &dynamic_resolution->config;
+    if (config->target_frame_seconds <= 0.0 || frame_seconds <= 0.0)
+    {
+        return false;
+    }
+
+    if (dynamic_resolution->smoothed_seconds <= 0.0)
+    {
+        dynamic_resolution->smoothed_seconds = frame_seconds;
+    }
+    else
+    {
+        dynamic_resolution->smoothed_seconds += DYNAMIC_RESOLUTION_SMOOTHING * (frame_seconds - dynamic_resolution->smoothed_seconds);
+    }
+
+    f64 ratio = config->target_frame_seconds / dynamic_resolution->smoothed_seconds;
+    if (ratio > 1.0 - DYNAMIC_RESOLUTION_DEADBAND && ratio < 1.0 + DYNAMIC_RESOLUTION_DEADBAND)
+    {
+        return false;
+    }
+    ratio = clamp<f64>(0.5, 1.5, ratio);
+
+    /**
+     * trace cost is proportional to pixel count times samples, so the controller works on
+     * scale^2 * spp and spends the budget on resolution first, then on samples */
+    f64 scale = dynamic_resolution->scale;
+    f64 work = scale * scale * dynamic_resolution->samples_per_pixel;
+    f64 target_work = work * ratio;
+
+    f64 max_scale = config->max_scale;
+    f64 full_resolution_work = max_scale * max_scale * config->min_samples_per_pixel;
+
+    f32 new_scale;
+    s32 new_samples_per_pixel;
+    if (target_work >= full_resolution_work)
+    {
+        new_scale = config->max_scale;
+        new_samples_per_pixel = (s32)std::lround(target_work / (max_scale * max_scale));
+        /** at low sample counts the rounding would swallow the growth, leaving 1 spp stuck below the budget */
+        if (ratio > 1.0 + DYNAMIC_RESOLUTION_DEADBAND && new_scale == dynamic_resolution->scale &&
+            new_samples_per_pixel <= dynamic_resolution->samples_per_pixel)
+        {
+            new_samples_per_pixel = dynamic_resolution->samples_per_pixel + 1;
+        }
+        new_samples_per_pixel = clamp<s32>(config->min_samples_per_pixel, config->max_samples_per_pixel, new_samples_per_pixel);
+    }
+    else
+    {
+        new_samples_per_pixel = config->min_samples_per_pixel;
+        new_scale = (f32)std::sqrt(target_work / config->min_samples_per_pixel);
+        new_scale = std::floor(new_scale * DYNAMIC_RESOLUTION_SCALE_STEPS) / DYNAMIC_RESOLUTION_SCALE_STEPS;
+        new_scale = clamp<f32>(config->min_scale, config->max_scale, new_scale);
+    }
+
+    if (new_scale == dynamic_resolution->scale && new_samples_per_pixel == dynamic_resolution->samples_per_pixel)
+    {
+        return false;
+    }
+
+    /** predict the cost of the new setting so the next frames do not overshoot */
+    f64 new_work = (f64)new_scale * new_scale * new_samples_per_pixel;
+    dynamic_resolution->smoothed_seconds *= new_work / work;
+
+    dynamic_resolution->scale = new_scale;
+    dynamic_resolution->samples_per_pixel = new_samples_per_pixel;
+    return true;
+}
+
+void dynamic_resolution_upscale(const u8* src, s32 src_width, s32 src_height,
+        u8* dst, s32 dst_width, s32 dst_height)
+{
+    const u32* src_pixels = (const u32 *)src;
+    u32* dst_pixel = (u32 *)dst;
+
+    /** 16.16 fixed point step through the source image, sampling at pixel centers */
+    s64 step_x = ((s64)src_width << 16) / dst_width;
+    s64 step_y = ((s64)src_height << 16) / dst_height;
+    s64 max_x = (s64)(src_width - 1) << 16;
+    s64 max_y = (s64)(src_height - 1) << 16;
+
+    for (s32 y = 0; y < dst_height; ++y)
+    {
+        s64 fy = clamp<s64>(0, max_y, (step_y >> 1) + y * step_y - (1 << 15));
+        s32 y0 = (s32)(fy >> 16);
+        s32 y1 = (y0 + 1 < src_height) ? y0 + 1 : y0;
+        u32 wy = (u32)(fy & 0xFFFF) >> 8;
+
+        const u32* row0 = src_pixels + (s64)y0 * src_width;
+        const u32* row1 = src_pixels + (s64)y1 * src_width;
+
+        for (s32 x = 0; x < dst_width; ++x)
+        {
+            s64 fx = clamp<s64>(0, max_x, (step_x >> 1) + x * step_x - (1 << 15));
+            s32 x0 = (s32)(fx >> 16);
+            s32 x1 = (x0 + 1 < src_width) ? x0 + 1 : x0;
+            u32 wx = (u32)(fx & 0xFFFF) >> 8;
+
+            u32 p00 = row0[x0];
+            u32 p01 = row0[x1];
+            u32 p10 = row1[x0];
+            u32 p11 = row1[x1];
+
+            u32 color = 0;
+            for (u32 shift = 0; shift < 32; shift += 8)
+            {
+                u32 c00 = (p00 >> shift) & 0xFF;
+                u32 c01 = (p01 >> shift) & 0xFF;
+                u32 c10 = (p10 >> shift) & 0xFF;
+                u32 c11 = (p11 >> shift) & 0xFF;
+
+                u32 top = c00 * (256 - wx) + c01 * wx;
+                u32 bottom = c10 * (256 - wx) + c11 * wx;
+                u32 value = (top * (256 - wy) + bottom * wy) >> 16;
+                color |= value << shift;
+            }
+
+            *dst_pixel++ = color;
+        }
+    }
+}
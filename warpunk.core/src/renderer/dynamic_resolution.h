@@ -0,0 +1,37 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+
+typedef struct dynamic_resolution_config
+{
+    /** render time budget per frame in seconds, trace, upscale and present included. 0 disables scaling */
+    f64 target_frame_seconds;
+    /** lowest and highest fraction of the output width rendered internally */
+    f32 min_scale;
+    f32 max_scale;
+    s32 min_samples_per_pixel;
+    s32 max_samples_per_pixel;
+} dynamic_resolution_config;
+
+typedef struct dynamic_resolution
+{
+    dynamic_resolution_config config;
+    /** current fraction of the output width rendered internally */
+    f32 scale;
+    s32 samples_per_pixel;
+    /** exponentially smoothed render time of the recent frames */
+    f64 smoothed_seconds;
+} dynamic_resolution;
+
+/** Starts at full quality, the first measured frames pull it down to the budget. */
+void dynamic_resolution_init(dynamic_resolution* dynamic_resolution, dynamic_resolution_config config);
+
+/**
+ * Feeds the render time of the last frame into the controller.
+ * @returns true if `scale` or `samples_per_pixel` changed and the camera has to follow.
+ */
+b8 dynamic_resolution_update(dynamic_resolution* dynamic_resolution, f64 frame_seconds);
+
+/** Bilinear upscale of a packed ARGB8 image into a larger ARGB8 image. */
+void dynamic_resolution_upscale(const u8* src, s32 src_width, s32 src_height,
+        u8* dst, s32 dst_width, s32 dst_height);
@@ -14,6 +14,11 @@ xcb_gcontext_t gcontext;
 
 b8 software_platform_startup()
 {
+    if (platform_is_headless())
+    {
+        return true;
+    }
+
     if (handle.connection == nullptr)
     {
         if (!platform_get_linux_handle(&handle))
@@ -47,6 +52,11 @@ b8 software_platform_startup()
 
 b8 software_platform_submit_framebuffer(s32 width, s32 height, s32 size, u8* framebuffer)
 {
+    if (platform_is_headless())
+    {
+        return platform_headless_submit_framebuffer(width, height, size, framebuffer);
+    }
+
     if (handle.connection == nullptr)
     {
         return false;
@@ -2,6 +2,7 @@
 #if defined(WARPUNK_WINDOWS)
 
 #include "warpunk.core/src/renderer/platform/software_platform.h"
+#include "warpunk.core/src/platform/platform.h"
 
 b8 software_platform_startup()
 {  
@@ -10,6 +11,11 @@ b8 software_platform_startup()
 
 b8 software_platform_submit_framebuffer(s32 width, s32 height, s32 size, u8* framebuffer)
 {
+    if (platform_is_headless())
+    {
+        return platform_headless_submit_framebuffer(width, height, size, framebuffer);
+    }
+
     return true;
 }
 
@@ -24,14 +24,14 @@ b8 renderer_startup(renderer_config renderer_config)
         case RENDERER_TYPE_SOFTWARE:
         {
             api.renderer_startup = software_renderer::renderer_startup;
-            //renderer_api.renderer_shutdown = software_renderer::renderer_shutdown;
+            api.renderer_shutdown = software_renderer::renderer_shutdown;
             api.renderer_begin_frame = software_renderer::renderer_begin_frame;
-            //renderer_api.renderer_end_frame = software_renderer::renderer_end_frame;
-            //renderer_api.renderer_create_buffer = software_renderer::renderer_create_buffer;
-            //renderer_api.renderer_destroy_buffer = software_renderer::renderer_destroy_buffer;
-            //renderer_api.renderer_create_texture = software_renderer::renderer_create_texture;
-            //renderer_api.renderer_destroy_texture = software_renderer::renderer_destroy_texture;
-            //renderer_api.renderer_draw = software_renderer::renderer_draw;
+            api.renderer_end_frame = software_renderer::renderer_end_frame;
+            api.renderer_create_buffer = software_renderer::renderer_create_buffer;
+            api.renderer_destroy_buffer = software_renderer::renderer_destroy_buffer;
+            api.renderer_create_texture = software_renderer::renderer_create_texture;
+            api.renderer_destroy_texture = software_renderer::renderer_destroy_texture;
+            api.renderer_draw = software_renderer::renderer_draw;
         } break;
         
         case RENDERER_TYPE_VULKAN:
@@ -73,7 +73,7 @@ buffer_handle renderer_create_buffer(s32 size, void* data)
 
 void renderer_destroy_buffer(buffer_handle buffer_handle)
 {
-    api.renderer_destroy_texture(buffer_handle);
+    api.renderer_destroy_buffer(buffer_handle);
 }
 
 texture_handle renderer_create_texture(s32 width, s32 height, void* data)
@@ -15,6 +15,10 @@ typedef struct renderer_config
     const char* application_name;
     s32 width;
     f64 aspect_ratio;
+    /** frame time budget the software renderer scales its resolution to, 0 renders at full quality */
+    f64 target_frame_seconds;
+    /** scene file written by scene_save, nullptr renders the built in four spheres */
+    const char* scene_path;
     renderer_config_flag flags;
 } renderer_config;
 
@@ -3,15 +3,64 @@
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/renderer/platform/software_platform.h"
 #include "warpunk.core/src/renderer/camera/camera.h"
+#include "warpunk.core/src/renderer/dynamic_resolution.h"
+#include "warpunk.core/src/renderer/scene/scene.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/container/slotmap.hpp"
+#include "warpunk.core/src/memory/pool.h"
+#include "warpunk.core/src/utils/profiler.h"
 
 #include "warpunk.core/src/math/hittable.hpp"
 
 #define BYTES_PER_PIXEL 4
+#define SOFTWARE_RENDERER_MAX_BUFFERS 4096
+#define SOFTWARE_RENDERER_MAX_TEXTURES 1024
+/** buffers up to this size come from a pool, so small per object buffers do not hit the heap */
+#define SOFTWARE_RENDERER_SMALL_BUFFER_SIZE 256
+#define SOFTWARE_RENDERER_SMALL_BUFFER_COUNT 1024
+/** share of the frame budget the trace keeps however long the last upscale and present took */
+#define SOFTWARE_RENDERER_MIN_TRACE_FRACTION 0.5
+
+typedef struct software_buffer
+{
+    s32 size;
+    u8* data;
+} software_buffer;
+
+typedef struct software_texture
+{
+    s32 width;
+    s32 height;
+    /** packed ARGB8 */
+    u8* pixels;
+} software_texture;
 
 static u8 framebuffer[1920 * 1080 * BYTES_PER_PIXEL];
+/** internal render target, upscaled into `framebuffer` when rendering below output resolution */
+static u8 render_buffer[1920 * 1080 * BYTES_PER_PIXEL];
 static camera_handle camera;
 static s32 width;
 static s32 height;
+static dynamic_resolution resolution;
+/** upscale and present time of the last frame, kept free at the end of the frame budget */
+static f64 present_seconds;
+
+static slotmap<software_buffer> buffers;
+static slotmap<software_texture> textures;
+static pool small_buffer_pool;
+
+/** small buffers go back to the pool, the rest to the heap */
+static void software_buffer_free_data(u8* data)
+{
+    if (pool_owns(&small_buffer_pool, data))
+    {
+        pool_free(&small_buffer_pool, data);
+    }
+    else
+    {
+        WFREE(data);
+    }
+}
 
 static material<f64> metal1 = { .type = METAL, .albedo = { 0.8, 0.8, 0.8 } };
 //static material<f64> metal2 = { .type = METAL, .fuzz = 0.66, .albedo = { 0.8, 0.6, 0.2 } };
@@ -21,6 +70,10 @@ static material<f64> lambert2 = { .type = LAMBERT, .albedo = { 0.1, 0.2, 0.5 } }
 static material<f64> dielectric1 = { .type = DIELECTRIC, .refraction_index=(1.00 / 1.33) };
 
 static sphere<f64> spheres[4];
+static scene loaded_scene;
+/** either `spheres` or the loaded scene */
+static sphere<f64>* scene_spheres;
+static s32 scene_sphere_count;
 
 
 namespace software_renderer
@@ -47,20 +100,211 @@ namespace software_renderer
         };
         camera = camera_create(camera_config);
 
+        /** dynamic resolution */
+        dynamic_resolution_config resolution_config = {
+            .target_frame_seconds = renderer_config.target_frame_seconds,
+            .min_scale = 0.25f,
+            .max_scale = 1.0f,
+            .min_samples_per_pixel = 1,
+            .max_samples_per_pixel = camera_config.samples_per_pixel,
+        };
+        dynamic_resolution_init(&resolution, resolution_config);
+
+        /** resources */
+        buffers = slotmap_create<software_buffer>(SOFTWARE_RENDERER_MAX_BUFFERS, allocator_heap(MEMORY_TAG_RENDERER));
+        textures = slotmap_create<software_texture>(SOFTWARE_RENDERER_MAX_TEXTURES, allocator_heap(MEMORY_TAG_RENDERER));
+        if (!pool_create(&small_buffer_pool, SOFTWARE_RENDERER_SMALL_BUFFER_SIZE, SOFTWARE_RENDERER_SMALL_BUFFER_COUNT, MEMORY_TAG_RENDERER))
+        {
+            slotmap_destroy(&buffers);
+            slotmap_destroy(&textures);
+            return false;
+        }
+
         /** spheres */
         spheres[0] = { .center = {  0.0,    0.0, -1.2 }, .radius =   0.5, .material = &lambert2 };
         spheres[1] = { .center = { -1.0,    0.0, -1.0 }, .radius =   0.5, .material = &metal1 };
         spheres[2] = { .center = {  1.0,    0.0, -1.0 }, .radius =   0.5, .material = &dielectric1 };
         spheres[3] = { .center = {  0.0, -100.5, -1.0 }, .radius = 100.0, .material = &metal3 };
+        scene_spheres = spheres;
+        scene_sphere_count = 4;
+
+        if (renderer_config.scene_path)
+        {
+            if (scene_load(&loaded_scene, renderer_config.scene_path))
+            {
+                scene_spheres = loaded_scene.spheres.data;
+                scene_sphere_count = (s32)loaded_scene.spheres.size;
+            }
+            else
+            {
+                WWARNING("Failed to load the scene %s, rendering the built-in spheres.", renderer_config.scene_path);
+            }
+        }
 
         return true;
     }   
 
     void renderer_begin_frame()
     {
-        camera_ray_cast(camera, spheres, framebuffer);
+        WPROFILE_FUNCTION();
 
-        [[maybe_unused]] bool _ = software_platform_submit_framebuffer(width, height, 
-                width * height * BYTES_PER_PIXEL, framebuffer);
+        f64 target_frame_seconds = resolution.config.target_frame_seconds;
+        f64 trace_start_time = platform_get_absolute_time();
+        f64 trace_deadline = 0.0;
+        if (target_frame_seconds > 0.0)
+        {
+            /** a slow present must not take the whole budget, every frame traces for a part of it */
+            f64 trace_budget = target_frame_seconds - present_seconds;
+            if (trace_budget < SOFTWARE_RENDERER_MIN_TRACE_FRACTION * target_frame_seconds)
+            {
+                trace_budget = SOFTWARE_RENDERER_MIN_TRACE_FRACTION * target_frame_seconds;
+            }
+            trace_deadline = trace_start_time + trace_budget;
+        }
+        camera_ray_cast_result ray_cast_result = camera_ray_cast(camera, scene_spheres, scene_sphere_count, render_buffer, trace_deadline);
+        f64 trace_end_time = platform_get_absolute_time();
+
+        s32 render_width;
+        s32 render_height;
+        camera_get_image_size(camera, &render_width, &render_height);
+
+        u8* present_buffer = render_buffer;
+        if (render_width != width || render_height != height)
+        {
+            WPROFILE_SCOPE("upscale");
+            dynamic_resolution_upscale(render_buffer, render_width, render_height, framebuffer, width, height);
+            present_buffer = framebuffer;
+        }
+
+        {
+            WPROFILE_SCOPE("present");
+            [[maybe_unused]] bool _ = software_platform_submit_framebuffer(width, height, 
+                    width * height * BYTES_PER_PIXEL, present_buffer);
+        }
+        f64 present_end_time = platform_get_absolute_time();
+        present_seconds = present_end_time - trace_end_time;
+
+        /** a failed ray cast says nothing about the cost of the frame, the controller only learns from traced ones */
+        if (ray_cast_result == CAMERA_RAY_CAST_RESULT_FAILED)
+        {
+            return;
+        }
+
+        f64 frame_seconds = present_end_time - trace_start_time;
+        if (ray_cast_result == CAMERA_RAY_CAST_RESULT_CUT)
+        {
+            /** the real cost of a cut frame is unknown, report the largest overrun the controller reacts to */
+            frame_seconds = 2.0 * target_frame_seconds;
+        }
+
+        if (dynamic_resolution_update(&resolution, frame_seconds))
+        {
+            camera_resize(camera, (s32)(width * resolution.scale));
+            camera_set_samples_per_pixel(camera, resolution.samples_per_pixel);
+
+            /** a cut frame keeps the old pixels where it did not get to, at the old row stride they are garbage */
+            s32 new_render_width;
+            camera_get_image_size(camera, &new_render_width, &render_height);
+            if (new_render_width != render_width)
+            {
+                platform_memory_zero(render_buffer, sizeof(render_buffer));
+            }
+        }
+    }
+
+    b8 renderer_shutdown()
+    {
+        /** the live resources are packed, release whatever the application did not destroy */
+        for (s64 buffer_idx = 0; buffer_idx < buffers.size; ++buffer_idx)
+        {
+            software_buffer* buffer = &buffers.data[buffer_idx];
+            software_buffer_free_data(buffer->data);
+        }
+        for (s64 texture_idx = 0; texture_idx < textures.size; ++texture_idx)
+        {
+            WFREE(textures.data[texture_idx].pixels);
+        }
+
+        slotmap_destroy(&buffers);
+        slotmap_destroy(&textures);
+        pool_destroy(&small_buffer_pool);
+        scene_destroy(&loaded_scene);
+        camera_destroy(camera);
+        return true;
+    }
+
+    void renderer_end_frame()
+    {
+    }
+
+    buffer_handle renderer_create_buffer(s32 size, void* data)
+    {
+        software_buffer buffer = { .size = size };
+        buffer.data = (size <= SOFTWARE_RENDERER_SMALL_BUFFER_SIZE) ? (u8 *)pool_alloc(&small_buffer_pool) : nullptr;
+        if (buffer.data == nullptr)
+        {
+            buffer.data = (u8 *)WALLOC(size, MEMORY_TAG_RENDERER);
+        }
+        if (data)
+        {
+            platform_memory_copy(buffer.data, data, size);
+        }
+
+        buffer_handle buffer_handle = slotmap_insert(&buffers, buffer);
+        if (buffer_handle == SLOTMAP_INVALID_HANDLE)
+        {
+            WERROR("No free buffer left, at most %d can exist at a time", SOFTWARE_RENDERER_MAX_BUFFERS);
+            software_buffer_free_data(buffer.data);
+        }
+        return buffer_handle;
+    }
+
+    void renderer_destroy_buffer(buffer_handle buffer_handle)
+    {
+        software_buffer* buffer = slotmap_get(&buffers, buffer_handle);
+        if (buffer == nullptr)
+        {
+            WERROR("Invalid buffer handle 0x%08x", buffer_handle);
+            return;
+        }
+
+        software_buffer_free_data(buffer->data);
+        slotmap_remove(&buffers, buffer_handle);
+    }
+
+    texture_handle renderer_create_texture(s32 width, s32 height, void* data)
+    {
+        s64 size = (s64)width * height * BYTES_PER_PIXEL;
+        software_texture texture = { .width = width, .height = height };
+        texture.pixels = (u8 *)WALLOC(size, MEMORY_TAG_RENDERER);
+        if (data)
+        {
+            platform_memory_copy(texture.pixels, data, size);
+        }
+
+        texture_handle texture_handle = slotmap_insert(&textures, texture);
+        if (texture_handle == SLOTMAP_INVALID_HANDLE)
+        {
+            WERROR("No free texture left, at most %d can exist at a time", SOFTWARE_RENDERER_MAX_TEXTURES);
+            WFREE(texture.pixels);
+        }
+        return texture_handle;
+    }
+
+    void renderer_destroy_texture(texture_handle texture_handle)
+    {
+        software_texture* texture = slotmap_get(&textures, texture_handle);
+        if (texture == nullptr)
+        {
+            WERROR("Invalid texture handle 0x%08x", texture_handle);
+            return;
+        }
+
+        WFREE(texture->pixels);
+        slotmap_remove(&textures, texture_handle);
+    }
+
+    void renderer_draw([[maybe_unused]] void* vertex_array, [[maybe_unused]] void* material)
+    {
     }
 }
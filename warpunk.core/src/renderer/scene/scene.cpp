@@ -0,0 +1,427 @@
+#include "warpunk.core/src/renderer/scene/scene.h"
+
+#include "warpunk.core/src/math/math_common.hpp"
+#include "warpunk.core/src/memory/memory_system.h"
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/logger.h"
+
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+
+/** the box in front of the camera the spheres are placed in, it sits on the ground sphere */
+#define SCENE_BOX_MIN_X -4.0
+#define SCENE_BOX_MAX_X  4.0
+#define SCENE_BOX_MIN_Y -0.5
+#define SCENE_BOX_MAX_Y  2.5
+#define SCENE_BOX_MIN_Z -12.0
+#define SCENE_BOX_MAX_Z -2.0
+/** fraction of the box volume covered by spheres, independent of the count */
+#define SCENE_FILL_FRACTION 0.05
+/** fraction of the box volume covered by the clusters */
+#define SCENE_CLUSTER_FRACTION 0.25
+/** outer glass, air gap, inner glass, solid core */
+#define SCENE_NEST_LAYERS 4
+#define SCENE_DEFAULT_MATERIAL_COUNT 16
+#define SCENE_SPHERES_PER_CLUSTER 1000
+
+#define SCENE_FILE_MAGIC 0x4E435357u /* "WSCN" */
+#define SCENE_FILE_VERSION 1
+/** records are converted in batches so saving and loading 10^7 spheres stays streaming */
+#define SCENE_FILE_BATCH 4096
+
+typedef struct scene_file_header
+{
+    u32 magic;
+    u32 version;
+    u64 material_count;
+    u64 sphere_count;
+} scene_file_header;
+
+typedef struct scene_file_material
+{
+    u32 type;
+    u32 reserved;
+    f64 fuzz;
+    f64 albedo[3];
+    f64 refraction_index;
+} scene_file_material;
+
+typedef struct scene_file_sphere
+{
+    f64 center[3];
+    f64 radius;
+    u64 material_index;
+} scene_file_sphere;
+
+/** same bit conversion as randreal01, the generator owns its engine so the scene only depends on the seed */
+static f64 scene_random01(random_engine* engine)
+{
+    return (f64)((*engine)() >> 11) * 0x1.0p-53;
+}
+
+static f64 scene_random(random_engine* engine, f64 low, f64 high)
+{
+    return low + (high - low) * scene_random01(engine);
+}
+
+static p3f64 scene_random_point_in_box(random_engine* engine, f64 radius)
+{
+    return { scene_random(engine, SCENE_BOX_MIN_X, SCENE_BOX_MAX_X),
+             scene_random(engine, SCENE_BOX_MIN_Y + radius, SCENE_BOX_MAX_Y),
+             scene_random(engine, SCENE_BOX_MIN_Z, SCENE_BOX_MAX_Z) };
+}
+
+static v3f64 scene_random_in_unit_ball(random_engine* engine)
+{
+    while (true)
+    {
+        v3f64 point = { scene_random(engine, -1.0, 1.0), scene_random(engine, -1.0, 1.0), scene_random(engine, -1.0, 1.0) };
+        if (length_squared(point) <= 1.0)
+        {
+            return point;
+        }
+    }
+}
+
+/** radius of `count` equal spheres that together fill `fraction` of the scene box */
+static f64 scene_radius_for_fill(f64 fraction, s64 count)
+{
+    const f64 box_volume = (SCENE_BOX_MAX_X - SCENE_BOX_MIN_X) * (SCENE_BOX_MAX_Y - SCENE_BOX_MIN_Y) *
+                           (SCENE_BOX_MAX_Z - SCENE_BOX_MIN_Z);
+    return std::cbrt(fraction * box_volume / (f64)count * 3.0 / (4.0 * pi64));
+}
+
+static void scene_generate_materials(scene* scene, random_engine* engine, const scene_generator_config* config)
+{
+    f64 total_weight = config->lambert_weight + config->metal_weight + config->dielectric_weight;
+    f64 lambert_weight = config->lambert_weight / total_weight;
+    f64 metal_weight = config->metal_weight / total_weight;
+
+    for (s32 material_idx = 0; material_idx < config->material_count; ++material_idx)
+    {
+        v3f64 albedo = { scene_random01(engine), scene_random01(engine), scene_random01(engine) };
+        f64 choice = scene_random01(engine);
+        if (choice < lambert_weight)
+        {
+            scene->materials.data[material_idx] = { .type = LAMBERT, .albedo = albedo };
+        }
+        else if (choice < lambert_weight + metal_weight)
+        {
+            scene->materials.data[material_idx] = { .type = METAL, .fuzz = 0.5 * scene_random01(engine), .albedo = albedo };
+        }
+        else
+        {
+            scene->materials.data[material_idx] = { .type = DIELECTRIC, .refraction_index = 1.5 };
+        }
+    }
+}
+
+static material<f64>* scene_random_material(scene* scene, random_engine* engine, s32 material_count)
+{
+    s32 material_idx = (s32)(scene_random01(engine) * material_count) % material_count;
+    return &scene->materials.data[material_idx];
+}
+
+static void scene_generate_uniform(scene* scene, random_engine* engine, const scene_generator_config* config)
+{
+    f64 radius = scene_radius_for_fill(SCENE_FILL_FRACTION, config->object_count);
+    for (s64 sphere_idx = 1; sphere_idx < config->object_count; ++sphere_idx)
+    {
+        p3f64 center = scene_random_point_in_box(engine, radius);
+        material<f64>* material = scene_random_material(scene, engine, config->material_count);
+        scene->spheres.data[sphere_idx] = { .center = center, .radius = radius, .material = material };
+    }
+}
+
+static void scene_generate_clustered(scene* scene, random_engine* engine, const scene_generator_config* config)
+{
+    s64 sphere_count = config->object_count - 1;
+    s32 cluster_count = config->cluster_count;
+    if (cluster_count <= 0)
+    {
+        cluster_count = (s32)((sphere_count + SCENE_SPHERES_PER_CLUSTER - 1) / SCENE_SPHERES_PER_CLUSTER);
+        cluster_count = (cluster_count < 1) ? 1 : cluster_count;
+    }
+
+    f64 radius = scene_radius_for_fill(SCENE_FILL_FRACTION, config->object_count);
+    f64 cluster_radius = scene_radius_for_fill(SCENE_CLUSTER_FRACTION, cluster_count);
+
+    dynarray<p3f64> cluster_centers = dynarray_create<p3f64>(cluster_count, allocator_heap(MEMORY_TAG_SCENE));
+    for (s32 cluster_idx = 0; cluster_idx < cluster_count; ++cluster_idx)
+    {
+        cluster_centers.data[cluster_idx] = scene_random_point_in_box(engine, cluster_radius);
+    }
+
+    for (s64 sphere_idx = 1; sphere_idx < config->object_count; ++sphere_idx)
+    {
+        s32 cluster_idx = (s32)(scene_random01(engine) * cluster_count) % cluster_count;
+        p3f64 center = cluster_centers.data[cluster_idx] + cluster_radius * scene_random_in_unit_ball(engine);
+        center.y = (center.y < SCENE_BOX_MIN_Y + radius) ? SCENE_BOX_MIN_Y + radius : center.y;
+        material<f64>* material = scene_random_material(scene, engine, config->material_count);
+        scene->spheres.data[sphere_idx] = { .center = center, .radius = radius, .material = material };
+    }
+
+    dynarray_destroy(&cluster_centers);
+}
+
+/** the glass and air materials are appended behind the generated table */
+static void scene_generate_nested_glass(scene* scene, random_engine* engine, const scene_generator_config* config)
+{
+    material<f64>* glass = &scene->materials.data[config->material_count];
+    material<f64>* air = &scene->materials.data[config->material_count + 1];
+    *glass = { .type = DIELECTRIC, .refraction_index = 1.5 };
+    *air = { .type = DIELECTRIC, .refraction_index = 1.0 / 1.5 };
+
+    const f64 layer_radius[SCENE_NEST_LAYERS] = { 1.0, 0.9, 0.6, 0.3 };
+
+    s64 nest_count = (config->object_count - 1 + SCENE_NEST_LAYERS - 1) / SCENE_NEST_LAYERS;
+    f64 outer_radius = scene_radius_for_fill(SCENE_FILL_FRACTION, nest_count);
+
+    p3f64 center = {};
+    for (s64 sphere_idx = 1; sphere_idx < config->object_count; ++sphere_idx)
+    {
+        s32 layer = (s32)((sphere_idx - 1) % SCENE_NEST_LAYERS);
+        if (layer == 0)
+        {
+            center = scene_random_point_in_box(engine, outer_radius);
+        }
+
+        material<f64>* material = glass;
+        if (layer == 1)
+        {
+            material = air;
+        }
+        else if (layer == SCENE_NEST_LAYERS - 1)
+        {
+            material = scene_random_material(scene, engine, config->material_count);
+        }
+
+        scene->spheres.data[sphere_idx] = { .center = center, .radius = outer_radius * layer_radius[layer], .material = material };
+    }
+}
+
+b8 scene_generate(scene* out_scene, scene_generator_config config)
+{
+    if (config.object_count < 1)
+    {
+        WERROR("A scene needs at least the ground sphere, got %lld objects", (long long)config.object_count);
+        return false;
+    }
+    if (config.material_count <= 0)
+    {
+        config.material_count = SCENE_DEFAULT_MATERIAL_COUNT;
+    }
+    if (config.lambert_weight + config.metal_weight + config.dielectric_weight <= 0.0f)
+    {
+        config.lambert_weight = 0.7f;
+        config.metal_weight = 0.2f;
+        config.dielectric_weight = 0.1f;
+    }
+
+    s32 extra_materials = (config.distribution == SCENE_DISTRIBUTION_NESTED_GLASS) ? 2 : 0;
+    out_scene->materials = dynarray_create<material<f64>>(config.material_count + extra_materials, allocator_heap(MEMORY_TAG_SCENE));
+    out_scene->spheres = dynarray_create<sphere<f64>>(config.object_count, allocator_heap(MEMORY_TAG_SCENE));
+    if (out_scene->spheres.data == nullptr || out_scene->materials.data == nullptr)
+    {
+        WERROR("Failed to allocate a scene of %lld spheres", (long long)config.object_count);
+        scene_destroy(out_scene);
+        return false;
+    }
+
+    random_engine engine = { config.seed };
+    scene_generate_materials(out_scene, &engine, &config);
+
+    out_scene->spheres.data[0] = { .center = { 0.0, -100.5, -1.0 }, .radius = 100.0, .material = &out_scene->materials.data[0] };
+
+    switch (config.distribution)
+    {
+        case SCENE_DISTRIBUTION_UNIFORM:
+        {
+            scene_generate_uniform(out_scene, &engine, &config);
+        } break;
+        case SCENE_DISTRIBUTION_CLUSTERED:
+        {
+            scene_generate_clustered(out_scene, &engine, &config);
+        } break;
+        case SCENE_DISTRIBUTION_NESTED_GLASS:
+        {
+            scene_generate_nested_glass(out_scene, &engine, &config);
+        } break;
+    }
+
+    return true;
+}
+
+void scene_destroy(scene* scene)
+{
+    dynarray_destroy(&scene->spheres);
+    dynarray_destroy(&scene->materials);
+}
+
+b8 scene_save(const scene* scene, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        WERROR("Failed to open scene file %s for writing", path);
+        return false;
+    }
+
+    scene_file_header header = {
+        .magic = SCENE_FILE_MAGIC,
+        .version = SCENE_FILE_VERSION,
+        .material_count = (u64)scene->materials.size,
+        .sphere_count = (u64)scene->spheres.size,
+    };
+    b8 result = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (s64 material_idx = 0; result && material_idx < scene->materials.size; ++material_idx)
+    {
+        const material<f64>* material = &scene->materials.data[material_idx];
+        scene_file_material record = {
+            .type = (u32)material->type,
+            .fuzz = material->fuzz,
+            .albedo = { material->albedo.x, material->albedo.y, material->albedo.z },
+            .refraction_index = material->refraction_index,
+        };
+        result = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+
+    arena_marker scratch_marker = memory_system_scratch_begin();
+    scene_file_sphere* batch = (scene_file_sphere *)arena_alloc(scratch_marker.arena, sizeof(scene_file_sphere) * SCENE_FILE_BATCH);
+    result = result && batch != nullptr;
+    for (s64 first_idx = 0; result && first_idx < scene->spheres.size; first_idx += SCENE_FILE_BATCH)
+    {
+        s64 batch_size = scene->spheres.size - first_idx;
+        batch_size = (batch_size > SCENE_FILE_BATCH) ? SCENE_FILE_BATCH : batch_size;
+        for (s64 batch_idx = 0; batch_idx < batch_size; ++batch_idx)
+        {
+            const sphere<f64>* sphere = &scene->spheres.data[first_idx + batch_idx];
+            batch[batch_idx] = {
+                .center = { sphere->center.x, sphere->center.y, sphere->center.z },
+                .radius = sphere->radius,
+                .material_index = (u64)(sphere->material - scene->materials.data),
+            };
+        }
+        result = fwrite(batch, sizeof(scene_file_sphere), batch_size, file) == (size_t)batch_size;
+    }
+    memory_system_scratch_end(scratch_marker);
+
+    if (fclose(file) != 0 || !result)
+    {
+        WERROR("Failed to write scene file %s", path);
+        return false;
+    }
+    return true;
+}
+
+b8 scene_load(scene* out_scene, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        WERROR("Failed to open scene file %s", path);
+        return false;
+    }
+
+    s64 file_size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        file_size = (s64)ftell(file);
+    }
+    scene_file_header header = {};
+    if (file_size < (s64)sizeof(header) || fseek(file, 0, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != SCENE_FILE_MAGIC || header.version != SCENE_FILE_VERSION ||
+        header.material_count == 0 || header.sphere_count == 0)
+    {
+        WERROR("%s is not a version %d scene file", path, SCENE_FILE_VERSION);
+        fclose(file);
+        return false;
+    }
+
+    /** the records have to fit into the file, a corrupt header must not size the allocations */
+    u64 record_bytes = (u64)file_size - sizeof(header);
+    if (header.material_count > record_bytes / sizeof(scene_file_material) ||
+        header.sphere_count > (record_bytes - header.material_count * sizeof(scene_file_material)) / sizeof(scene_file_sphere))
+    {
+        WERROR("Scene file %s is truncated or corrupt", path);
+        fclose(file);
+        return false;
+    }
+
+    out_scene->materials = dynarray_create<material<f64>>(header.material_count, allocator_heap(MEMORY_TAG_SCENE));
+    out_scene->spheres = dynarray_create<sphere<f64>>(header.sphere_count, allocator_heap(MEMORY_TAG_SCENE));
+    b8 result = out_scene->materials.data != nullptr && out_scene->spheres.data != nullptr;
+
+    for (u64 material_idx = 0; result && material_idx < header.material_count; ++material_idx)
+    {
+        scene_file_material record;
+        if (fread(&record, sizeof(record), 1, file) != 1 || record.type > DIELECTRIC)
+        {
+            result = false;
+            break;
+        }
+        out_scene->materials.data[material_idx] = {
+            .type = (material_type)record.type,
+            .fuzz = record.fuzz,
+            .albedo = { record.albedo[0], record.albedo[1], record.albedo[2] },
+            .refraction_index = record.refraction_index,
+        };
+    }
+
+    arena_marker scratch_marker = memory_system_scratch_begin();
+    scene_file_sphere* batch = (scene_file_sphere *)arena_alloc(scratch_marker.arena, sizeof(scene_file_sphere) * SCENE_FILE_BATCH);
+    result = result && batch != nullptr;
+    for (u64 first_idx = 0; result && first_idx < header.sphere_count; first_idx += SCENE_FILE_BATCH)
+    {
+        u64 batch_size = header.sphere_count - first_idx;
+        batch_size = (batch_size > SCENE_FILE_BATCH) ? SCENE_FILE_BATCH : batch_size;
+        result = fread(batch, sizeof(scene_file_sphere), batch_size, file) == batch_size;
+        for (u64 batch_idx = 0; result && batch_idx < batch_size; ++batch_idx)
+        {
+            const scene_file_sphere* record = &batch[batch_idx];
+            if (record->material_index >= header.material_count)
+            {
+                result = false;
+                break;
+            }
+            out_scene->spheres.data[first_idx + batch_idx] = {
+                .center = { record->center[0], record->center[1], record->center[2] },
+                .radius = record->radius,
+                .material = &out_scene->materials.data[record->material_index],
+            };
+        }
+    }
+    memory_system_scratch_end(scratch_marker);
+
+    fclose(file);
+    if (!result)
+    {
+        WERROR("Scene file %s is truncated or corrupt", path);
+        scene_destroy(out_scene);
+        return false;
+    }
+    return true;
+}
+
+b8 scene_distribution_from_string(const char* name, scene_distribution* out_distribution)
+{
+    if (strcmp(name, "uniform") == 0)
+    {
+        *out_distribution = SCENE_DISTRIBUTION_UNIFORM;
+    }
+    else if (strcmp(name, "clustered") == 0)
+    {
+        *out_distribution = SCENE_DISTRIBUTION_CLUSTERED;
+    }
+    else if (strcmp(name, "nested_glass") == 0)
+    {
+        *out_distribution = SCENE_DISTRIBUTION_NESTED_GLASS;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
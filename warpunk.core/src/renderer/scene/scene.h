@@ -0,0 +1,56 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/container/dynarray.hpp"
+#include "warpunk.core/src/math/hittable.hpp"
+
+typedef enum scene_distribution
+{
+    /** spheres spread evenly through the scene box */
+    SCENE_DISTRIBUTION_UNIFORM,
+    /** spheres packed around a few random centers, dense and empty regions side by side */
+    SCENE_DISTRIBUTION_CLUSTERED,
+    /** concentric glass shells around a solid core, every camera ray refracts many times */
+    SCENE_DISTRIBUTION_NESTED_GLASS,
+} scene_distribution;
+
+typedef struct scene_generator_config
+{
+    /** number of spheres including the ground sphere */
+    s64 object_count;
+    scene_distribution distribution;
+    u64 seed;
+    /** size of the material table the spheres pick from */
+    s32 material_count;
+    /** relative weights of the material types in the table, all 0 picks the defaults */
+    f32 lambert_weight;
+    f32 metal_weight;
+    f32 dielectric_weight;
+    /** number of clusters for SCENE_DISTRIBUTION_CLUSTERED, 0 picks one per 1000 spheres */
+    s32 cluster_count;
+} scene_generator_config;
+
+/** @brief Spheres in a flat array, their material pointers point into `materials`. */
+typedef struct scene
+{
+    dynarray<sphere<f64>> spheres;
+    dynarray<material<f64>> materials;
+} scene;
+
+/**
+ * Generates a scene in front of the default camera (looking down -z from the origin). The same config always
+ * produces the same scene. The first sphere is the ground, the density stays the same for every object count.
+ */
+warpunk_api b8 scene_generate(scene* out_scene, scene_generator_config config);
+
+/** */
+warpunk_api void scene_destroy(scene* scene);
+
+/** Writes the scene in a little endian binary format, material pointers are stored as indices. */
+warpunk_api b8 scene_save(const scene* scene, const char* path);
+
+/** */
+warpunk_api b8 scene_load(scene* out_scene, const char* path);
+
+/** @returns false if `name` is none of "uniform", "clustered" or "nested_glass". */
+warpunk_api b8 scene_distribution_from_string(const char* name, scene_distribution* out_distribution);
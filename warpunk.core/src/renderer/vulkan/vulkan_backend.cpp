@@ -9,6 +9,7 @@
 #include "warpunk.core/src/renderer/platform/vulkan_platform.h"
 #include "warpunk.core/src/renderer/vulkan/vulkan_device.h"
 #include "warpunk.core/src/renderer/vulkan/vulkan_swapchain.h"
+#include "warpunk.core/src/utils/profiler.h"
 
 namespace vulkan_renderer 
 {
@@ -19,7 +20,7 @@ namespace vulkan_renderer
     static void vulkan_memory_alloc_notification(void* user_data, size_t size, VkInternalAllocationType allocation_type, VkSystemAllocationScope allocation_scope);
     static void vulkan_memory_free_notification(void* user_data, size_t size, VkInternalAllocationType allocation_type, VkSystemAllocationScope allocation_scope);
 
-    static b8 vulkan_check_validation_layer_support(dynarray<const char*>* validation_layers);
+    static b8 vulkan_check_validation_layer_support(stcarray<const char*, VULKAN_MAX_VALIDATION_LAYERS>* validation_layers);
 
     static vulkan_context context;
     // TODO: move
@@ -27,6 +28,8 @@ namespace vulkan_renderer
 
     b8 renderer_startup(renderer_config renderer_config)
     {
+        WPROFILE_FUNCTION();
+
         if (context.is_initialized)
         {
             return true;
@@ -34,10 +37,10 @@ namespace vulkan_renderer
         context.config_flags = renderer_config.flags;
 
         // Custom allocator
-        context.allocator = (VkAllocationCallbacks *)platform_memory_alloc(sizeof(VkAllocationCallbacks));
+        context.allocator = (VkAllocationCallbacks *)WALLOC(sizeof(VkAllocationCallbacks), MEMORY_TAG_RENDERER);
         if (!vulkan_allocator_create(&context, context.allocator))
         {
-            platform_memory_free(context.allocator);
+            WFREE(context.allocator);
             WERROR("Failed to create Vulkan memory allocator. Continuing using the driver's default allocator.");
             context.allocator = 0;
         }
@@ -79,8 +82,8 @@ namespace vulkan_renderer
 
         // validation layers
 
-        dynarray<const char*> validation_layers = dynarray_empty<const char *>();
-        dynarray_add(&validation_layers, "VK_LAYER_KHRONOS_validation");
+        stcarray<const char*, VULKAN_MAX_VALIDATION_LAYERS> validation_layers = stcarray_create<const char*, VULKAN_MAX_VALIDATION_LAYERS>();
+        stcarray_add(&validation_layers, "VK_LAYER_KHRONOS_validation");
 #ifdef WARPUNK_DEBUG
         const b8 enable_validation_layers = true;
 #else
@@ -93,13 +96,12 @@ namespace vulkan_renderer
 
         if (enable_validation_layers)
         {
-            instance_create_info.enabledLayerCount = validation_layers.capacity;
+            instance_create_info.enabledLayerCount = validation_layers.size;
             instance_create_info.ppEnabledLayerNames = validation_layers.data;
         }
 
         vulkan_eval_result(vkCreateInstance(&instance_create_info, nullptr, &context.instance));
         dynarray_destroy(&instance_extensions);
-        dynarray_destroy(&validation_layers);
 
         WSUCCESS("Vulkan Instance created.");
 
@@ -157,40 +159,45 @@ namespace vulkan_renderer
 
     b8 renderer_shutdown()
     {
+        WPROFILE_FUNCTION();
+
         vkDestroyInstance(context.instance, NULL);
 
         return true;
     }
 
 
-    void renderer_device_query_swapchain_support(vulkan_swapchain_support_info* out_swapchain_support)
+    b8 renderer_device_query_swapchain_support(vulkan_swapchain_support_info* out_swapchain_support)
     {
         // surface capabilities
         vulkan_eval_result(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(context.device.physical_device, context.surface, &out_swapchain_support->capabilities));        
         
         // surface formats
-        vulkan_eval_result(vkGetPhysicalDeviceSurfaceFormatsKHR(context.device.physical_device, context.surface, &out_swapchain_support->format_count, 0));
-        if (out_swapchain_support->format_count != 0)
+        u32 format_count = 0;
+        vulkan_eval_result(vkGetPhysicalDeviceSurfaceFormatsKHR(context.device.physical_device, context.surface, &format_count, 0));
+        if (!smallarray_resize(&out_swapchain_support->formats, format_count))
         {
-            if (!out_swapchain_support->formats)
-            {
-                out_swapchain_support->formats = (VkSurfaceFormatKHR *)platform_memory_alloc(sizeof(VkSurfaceFormatKHR) * out_swapchain_support->format_count);
-            }
-
-            vulkan_eval_result(vkGetPhysicalDeviceSurfaceFormatsKHR(context.device.physical_device, context.surface, &out_swapchain_support->format_count, out_swapchain_support->formats));
+            WERROR("Failed to allocate %u surface formats.", format_count);
+            return false;
+        }
+        if (format_count != 0)
+        {
+            vulkan_eval_result(vkGetPhysicalDeviceSurfaceFormatsKHR(context.device.physical_device, context.surface, &format_count, smallarray_data(&out_swapchain_support->formats)));
         }
 
         // present modes
-        vulkan_eval_result(vkGetPhysicalDeviceSurfacePresentModesKHR(context.device.physical_device, context.surface, &out_swapchain_support->present_mode_count, 0));
-        if (out_swapchain_support->present_mode_count != 0)
+        u32 present_mode_count = 0;
+        vulkan_eval_result(vkGetPhysicalDeviceSurfacePresentModesKHR(context.device.physical_device, context.surface, &present_mode_count, 0));
+        if (!smallarray_resize(&out_swapchain_support->present_modes, present_mode_count))
         {
-            if (!out_swapchain_support->present_modes)
-            {
-                out_swapchain_support->present_modes = (VkPresentModeKHR *)platform_memory_alloc(sizeof(VkPresentModeKHR) * out_swapchain_support->present_mode_count);
-            }
-
-            vulkan_eval_result(vkGetPhysicalDeviceSurfacePresentModesKHR(context.device.physical_device, context.surface, &out_swapchain_support->present_mode_count, out_swapchain_support->present_modes));
+            WERROR("Failed to allocate %u present modes.", present_mode_count);
+            return false;
         }
+        if (present_mode_count != 0)
+        {
+            vulkan_eval_result(vkGetPhysicalDeviceSurfacePresentModesKHR(context.device.physical_device, context.surface, &present_mode_count, smallarray_data(&out_swapchain_support->present_modes)));
+        }
+        return true;
     }
 
 /**
@@ -220,7 +227,7 @@ namespace vulkan_renderer
             return nullptr;
         }
 
-        void* result = platform_memory_alloc(size);
+        void* result = WALLOC(size, MEMORY_TAG_RENDERER);
         return result;
     }
     
@@ -233,18 +240,17 @@ namespace vulkan_renderer
 
         if (size == 0)
         {
-            platform_memory_free(user_data);
+            vulkan_memory_free(user_data, original);
             return nullptr;
         }
 
-        void* result = vulkan_memory_alloc(user_data, size, alignment, allocation_scope);
+        void* result = WREALLOC(original, size);
         if (!result)
         {
             WERROR("Failed to realloc %p.", original);
             return nullptr;
         }
 
-        platform_memory_copy(result, original, size);
         return result;
     }
     
@@ -256,7 +262,7 @@ namespace vulkan_renderer
             return;
         }
 
-        platform_memory_free(memory);
+        WFREE(memory);
     }
     
     static void vulkan_memory_alloc_notification(void* user_data, size_t size, VkInternalAllocationType allocation_type, VkSystemAllocationScope allocation_scope)
@@ -269,14 +275,14 @@ namespace vulkan_renderer
         WVERBOSE("External free of size: %llu", size);
     }
 
-    static b8 vulkan_check_validation_layer_support(dynarray<const char*>* validation_layers)
+    static b8 vulkan_check_validation_layer_support(stcarray<const char*, VULKAN_MAX_VALIDATION_LAYERS>* validation_layers)
     {
         u32 layer_count;
         vkEnumerateInstanceLayerProperties(&layer_count, nullptr);
         dynarray<VkLayerProperties> available_layers = dynarray_create<VkLayerProperties>(layer_count);
         vkEnumerateInstanceLayerProperties(&layer_count, available_layers.data);
         
-        for (u32 layer_idx = 0; layer_idx < validation_layers->capacity; ++layer_idx)
+        for (u32 layer_idx = 0; layer_idx < validation_layers->size; ++layer_idx)
         {
             b8 layer_found = false;
             const char* layer_name = validation_layers->data[layer_idx];
@@ -34,5 +34,5 @@ namespace vulkan_renderer
 
 
     /** */
-    void renderer_device_query_swapchain_support(struct vulkan_swapchain_support_info* out_swapchain_support);
+    b8 renderer_device_query_swapchain_support(struct vulkan_swapchain_support_info* out_swapchain_support);
 }
@@ -1,5 +1,6 @@
 #include "warpunk.core/src/renderer/vulkan/vulkan_device.h"
 #include "warpunk.core/src/renderer/platform/vulkan_platform.h"
+#include "warpunk.core/src/container/hashset.hpp"
 
 namespace vulkan_renderer
 {
@@ -10,7 +11,7 @@ namespace vulkan_renderer
         b8 compute;
         b8 transfer;
     
-        dynarray<const char*> device_extension_names;
+        stcarray<const char*, VULKAN_MAX_DEVICE_EXTENSIONS> device_extension_names;
         b8 sampler_anisotropy;
         b8 discrete_gpu;
     } vulkan_physical_device_requirements;
@@ -67,7 +68,7 @@ namespace vulkan_renderer
             queue_indices[queue_index++] = context->device.transfer_queue_index;
         }
 
-        dynarray<VkDeviceQueueCreateInfo> queue_create_info = dynarray_create<VkDeviceQueueCreateInfo>(index_count);        
+        dynarray<VkDeviceQueueCreateInfo> queue_create_info = dynarray_create_zeroed<VkDeviceQueueCreateInfo>(index_count);        
         f32 queue_priorities[2] = { 0.9f, 1.0f };
        
         VkQueueFamilyProperties props[64];
@@ -113,20 +114,20 @@ namespace vulkan_renderer
             vulkan_eval_result(vkEnumerateDeviceExtensionProperties(context->device.physical_device, nullptr, &available_device_extension_count, device_extension_properties.data));
         }
 
-        dynarray<const char*> device_extension_names = dynarray_empty<const char *>();
-        dynarray_add(&device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        stcarray<const char*, VULKAN_MAX_DEVICE_EXTENSIONS> device_extension_names = stcarray_create<const char*, VULKAN_MAX_DEVICE_EXTENSIONS>();
+        stcarray_add(&device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
         // If native support for dynamic state is missing but the extension is available,
         // enable the required extensions for dynamic state and dynamic rendering.
         if (!context->device.supports_dynamic_state_natively && context->device.supports_dynamic_state)
         {
-            dynarray_add(&device_extension_names, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
-            dynarray_add(&device_extension_names, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+            stcarray_add(&device_extension_names, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+            stcarray_add(&device_extension_names, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
         }
         // If the device supports smooth (antialiased) lines, enable the line rasterization extension.
         if (context->device.supports_smooth_lines)
         {
-            dynarray_add(&device_extension_names, VK_EXT_LINE_RASTERIZATION_EXTENSION_NAME);
+            stcarray_add(&device_extension_names, VK_EXT_LINE_RASTERIZATION_EXTENSION_NAME);
         }
 
         // Set up the device features to request, based on what the physical device supports.
@@ -173,7 +174,7 @@ namespace vulkan_renderer
         device_create_info.queueCreateInfoCount = index_count;
         device_create_info.pQueueCreateInfos = queue_create_info.data;
         device_create_info.pEnabledFeatures = 0;
-        device_create_info.enabledExtensionCount = device_extension_names.capacity;
+        device_create_info.enabledExtensionCount = device_extension_names.size;
         device_create_info.ppEnabledExtensionNames = device_extension_names.data;
         
         device_create_info.enabledLayerCount = 0;
@@ -186,7 +187,6 @@ namespace vulkan_renderer
 
         dynarray_destroy(&queue_create_info);
         dynarray_destroy(&device_extension_properties);
-        dynarray_destroy(&device_extension_names);
 
         WSUCCESS("logical device created.");
 
@@ -254,8 +254,8 @@ namespace vulkan_renderer
         requirements.present = true;
         requirements.compute = true;
         requirements.transfer = true;
-        requirements.device_extension_names = dynarray_empty<const char*>();
-        dynarray_add(&requirements.device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        requirements.device_extension_names = stcarray_create<const char*, VULKAN_MAX_DEVICE_EXTENSIONS>();
+        stcarray_add(&requirements.device_extension_names, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
         requirements.sampler_anisotropy = true;
         requirements.discrete_gpu = true;
 
@@ -508,7 +508,7 @@ namespace vulkan_renderer
             WINFO("Transfer queue family index: %d", out_queue_family_info->transfer_queue_index);
             WINFO("Compute  queue family index: %d", out_queue_family_info->compute_queue_index);
 
-            if (requirements->device_extension_names.data)
+            if (requirements->device_extension_names.size > 0)
             {
                 u32 available_extension_count = 0;
                 dynarray<VkExtensionProperties> available_extensions = dynarray_empty<VkExtensionProperties>();
@@ -518,25 +518,23 @@ namespace vulkan_renderer
                     available_extensions = dynarray_create<VkExtensionProperties>(available_extension_count);
                     vulkan_eval_result(vkEnumerateDeviceExtensionProperties(device, 0, &available_extension_count, available_extensions.data));
 
-                    for (u32 requirement_index = 0; requirement_index < requirements->device_extension_names.capacity; ++requirement_index) 
+                    hashset<const char*> available_extension_names = hashset_create<const char*>(available_extension_count);
+                    for (u32 available_index = 0; available_index < available_extension_count; ++available_index) 
                     {
-                        b8 found = false;
-                        for (u32 available_index = 0; available_index < available_extension_count; ++available_index) 
-                        {
-                            if (strcmp(requirements->device_extension_names.data[requirement_index], available_extensions.data[available_index].extensionName) == 0) 
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-    
-                        if (!found) 
+                        hashset_insert(&available_extension_names, (const char*)available_extensions.data[available_index].extensionName);
+                    }
+
+                    for (u32 requirement_index = 0; requirement_index < requirements->device_extension_names.size; ++requirement_index) 
+                    {
+                        if (!hashset_contains(&available_extension_names, requirements->device_extension_names.data[requirement_index])) 
                         {
                             WERROR("Required extension not found: '%s', skipping device.", requirements->device_extension_names.data[requirement_index]);
+                            hashset_destroy(&available_extension_names);
                             dynarray_destroy(&available_extensions);
                             return false;
                         }
                     }
+                    hashset_destroy(&available_extension_names);
                 }
                 dynarray_destroy(&available_extensions);
             }
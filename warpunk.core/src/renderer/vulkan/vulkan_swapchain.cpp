@@ -33,14 +33,18 @@ namespace vulkan_renderer
     static b8 vulkan_swapchain_create_internal(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* out_swapchain)
     {
         vulkan_swapchain_support_info* swapchain_support = &context->device.swapchain_support;
-        renderer_device_query_swapchain_support(swapchain_support);
+        if (!renderer_device_query_swapchain_support(swapchain_support))
+        {
+            return false;
+        }
      
         VkExtent2D swapchain_extent = { width, height };
 
         b8 found = false;
-        for (u32 format_index = 0; format_index < swapchain_support->format_count; ++format_index)
+        VkSurfaceFormatKHR* formats = smallarray_data(&swapchain_support->formats);
+        for (u32 format_index = 0; format_index < swapchain_support->formats.size; ++format_index)
         {
-            VkSurfaceFormatKHR surface_format = swapchain_support->formats[format_index];
+            VkSurfaceFormatKHR surface_format = formats[format_index];
              
             if (surface_format.format == VK_FORMAT_B8G8R8A8_UNORM && 
                 surface_format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
@@ -53,7 +57,7 @@ namespace vulkan_renderer
 
         if (!found)
         {
-            out_swapchain->image_format = swapchain_support->formats[0];
+            out_swapchain->image_format = formats[0];
         }
 
         VkFormatProperties format_properties = {};
@@ -71,10 +75,10 @@ namespace vulkan_renderer
             if ((context->config_flags & RENDERER_CONFIG_FLAG_POWER_SAVING_BIT) == 0) 
             {
                 for (u32 present_mode_index = 0; 
-                     present_mode_index < swapchain_support->present_mode_count; 
+                     present_mode_index < swapchain_support->present_modes.size; 
                      ++present_mode_index)
                 {
-                    VkPresentModeKHR mode = swapchain_support->present_modes[present_mode_index];
+                    VkPresentModeKHR mode = smallarray_data(&swapchain_support->present_modes)[present_mode_index];
                     if (mode == VK_PRESENT_MODE_MAILBOX_KHR) 
                     {
                         present_mode = mode;
@@ -88,16 +92,10 @@ namespace vulkan_renderer
             present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
         }
 
-        if (swapchain_support->format_count < 1 || swapchain_support->present_mode_count < 1) 
+        if (swapchain_support->formats.size < 1 || swapchain_support->present_modes.size < 1) 
         {
-            if (swapchain_support->formats) 
-            {
-                platform_memory_free(swapchain_support->formats);
-            }
-            if (swapchain_support->present_modes) 
-            {
-                platform_memory_free(swapchain_support->present_modes);
-            }
+            smallarray_destroy(&swapchain_support->formats);
+            smallarray_destroy(&swapchain_support->present_modes);
 
             WERROR("Required swapchain support not present, skipping device.\n");
             return false;
@@ -8,6 +8,8 @@
 
 #include "warpunk.core/src/defines.h"
 #include "warpunk.core/src/container/dynarray.hpp"
+#include "warpunk.core/src/container/smallarray.hpp"
+#include "warpunk.core/src/container/stcarray.hpp"
 #include "warpunk.core/src/renderer/renderer_types.h"
 
 #define vulkan_eval_result(vk_result)               \
@@ -21,6 +23,12 @@
         }                                           \
     } while (0)
 
+/** drivers report a handful of formats and present modes, more than this spills to the heap */
+#define VULKAN_INLINE_SURFACE_FORMAT_COUNT 16
+#define VULKAN_INLINE_PRESENT_MODE_COUNT 8
+#define VULKAN_MAX_DEVICE_EXTENSIONS 8
+#define VULKAN_MAX_VALIDATION_LAYERS 4
+
 namespace vulkan_renderer
 {
     struct vulkan_context;
@@ -29,14 +37,10 @@ namespace vulkan_renderer
     {
         /** @brief Surface capabilities such as min/max image count, extent, etc. */
         VkSurfaceCapabilitiesKHR capabilities;
-        /** @brief Number of supported surface formats. */
-        u32 format_count;
-        /** @brief Array of supported surface formats. */
-        VkSurfaceFormatKHR* formats;
-        /** @brief Number of supported present modes. */
-        u32 present_mode_count;
-        /** @brief Array of supported present modes. */
-        VkPresentModeKHR* present_modes;
+        /** @brief Supported surface formats. */
+        smallarray<VkSurfaceFormatKHR, VULKAN_INLINE_SURFACE_FORMAT_COUNT> formats;
+        /** @brief Supported present modes. */
+        smallarray<VkPresentModeKHR, VULKAN_INLINE_PRESENT_MODE_COUNT> present_modes;
     } vulkan_swapchain_support_info;
 
 
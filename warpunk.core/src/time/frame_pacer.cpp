@@ -0,0 +1,74 @@
+#include "warpunk.core/src/time/frame_pacer.h"
+
+#include "warpunk.core/src/platform/platform.h"
+
+/** spin time before the first sleeps were measured */
+#define FRAME_PACER_INITIAL_SPIN_SECONDS 0.001
+#define FRAME_PACER_MIN_SPIN_SECONDS 0.0001
+#define FRAME_PACER_MAX_SPIN_SECONDS 0.004
+/** the spin covers this multiple of the worst recent oversleep */
+#define FRAME_PACER_SPIN_HEADROOM 1.25
+/** how fast the spin shrinks back after a long oversleep, per frame */
+#define FRAME_PACER_SPIN_DECAY 0.99
+
+void frame_pacer_init(frame_pacer* frame_pacer, frame_pacer_config config)
+{
+    *frame_pacer = {};
+    frame_pacer->config = config;
+    frame_pacer->spin_seconds = FRAME_PACER_INITIAL_SPIN_SECONDS;
+}
+
+void frame_pacer_reset(frame_pacer* frame_pacer)
+{
+    frame_pacer->next_frame_time = 0.0;
+}
+
+void frame_pacer_wait(frame_pacer* frame_pacer)
+{
+    if (frame_pacer->config.mode != FRAME_PACER_MODE_FIXED || frame_pacer->config.target_frame_seconds <= 0.0)
+    {
+        return;
+    }
+
+    f64 now = platform_get_absolute_time();
+    f64 frame_seconds = frame_pacer->config.target_frame_seconds;
+    if (frame_pacer->next_frame_time == 0.0 || now - frame_pacer->next_frame_time > frame_seconds)
+    {
+        if (frame_pacer->next_frame_time != 0.0)
+        {
+            frame_pacer->missed_frame_count++;
+        }
+        frame_pacer->next_frame_time = now + frame_seconds;
+        return;
+    }
+
+    f64 deadline = frame_pacer->next_frame_time;
+    frame_pacer->next_frame_time += frame_seconds;
+
+    f64 wake_time = deadline - frame_pacer->spin_seconds;
+    if (now < wake_time)
+    {
+        platform_sleep_until(wake_time);
+
+        /** the spin has to cover the scheduler's wakeup latency, grow it at once and shrink it slowly */
+        f64 oversleep = platform_get_absolute_time() - wake_time;
+        f64 spin_seconds = frame_pacer->spin_seconds * FRAME_PACER_SPIN_DECAY;
+        if (oversleep * FRAME_PACER_SPIN_HEADROOM > spin_seconds)
+        {
+            spin_seconds = oversleep * FRAME_PACER_SPIN_HEADROOM;
+        }
+        if (spin_seconds < FRAME_PACER_MIN_SPIN_SECONDS)
+        {
+            spin_seconds = FRAME_PACER_MIN_SPIN_SECONDS;
+        }
+        if (spin_seconds > FRAME_PACER_MAX_SPIN_SECONDS)
+        {
+            spin_seconds = FRAME_PACER_MAX_SPIN_SECONDS;
+        }
+        frame_pacer->spin_seconds = spin_seconds;
+    }
+
+    while (platform_get_absolute_time() < deadline)
+    {
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+
+typedef enum frame_pacer_mode
+{
+    /** frames start every target_frame_seconds */
+    FRAME_PACER_MODE_FIXED,
+    /** never waits */
+    FRAME_PACER_MODE_UNLIMITED,
+    /** never waits, the blocking present of a vsynced swapchain paces the frames */
+    FRAME_PACER_MODE_VSYNC
+} frame_pacer_mode;
+
+typedef struct frame_pacer_config
+{
+    frame_pacer_mode mode;
+    /** 1/60, 1/120... only used by FRAME_PACER_MODE_FIXED */
+    f64 target_frame_seconds;
+} frame_pacer_config;
+
+typedef struct frame_pacer
+{
+    frame_pacer_config config;
+    /** when the next frame should start on the platform_get_absolute_time clock, 0 before the first wait */
+    f64 next_frame_time;
+    /** how long before the deadline the sleep ends and the spin takes over, follows the observed oversleep */
+    f64 spin_seconds;
+    /** frames that started so late the schedule was reset */
+    s64 missed_frame_count;
+} frame_pacer;
+
+/** */
+no_mangle warpunk_api void frame_pacer_init(frame_pacer* frame_pacer, frame_pacer_config config);
+
+/** Starts a new schedule with the next wait, after the loop paused (suspended, loading). */
+no_mangle warpunk_api void frame_pacer_reset(frame_pacer* frame_pacer);
+
+/**
+ * Blocks until the next frame is due, called once per frame. Sleeps until shortly before the deadline and
+ * spins the rest, so the frame starts on time without a core busy waiting the whole frame.
+ * The deadlines advance by exactly one frame so early and late wakeups do not add up over time,
+ * a frame that missed its deadline by more than a whole frame restarts the schedule instead of catching up.
+ */
+no_mangle warpunk_api void frame_pacer_wait(frame_pacer* frame_pacer);
@@ -0,0 +1,176 @@
+#include "warpunk.core/src/time/frame_stats.h"
+
+#include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/utils/logger.h"
+
+#include <algorithm>
+
+#define FRAME_STATS_DEFAULT_HITCH_FACTOR 2.0
+/** weight of the newest frame in the smoothed frame time */
+#define FRAME_STATS_SMOOTHING 0.05
+
+static const char* phase_names[FRAME_STATS_PHASE_COUNT] = { "frame", "update", "render" };
+
+void frame_stats_init(frame_stats* frame_stats, frame_stats_config config)
+{
+    if (config.hitch_factor <= 1.0)
+    {
+        config.hitch_factor = FRAME_STATS_DEFAULT_HITCH_FACTOR;
+    }
+
+    *frame_stats = {};
+    frame_stats->config = config;
+    frame_stats->last_report_time = platform_get_absolute_time();
+}
+
+void frame_stats_record(frame_stats* frame_stats, frame_stats_phase phase, f64 seconds)
+{
+    frame_stats->current[phase] += seconds;
+}
+
+void frame_stats_record_counters(frame_stats* frame_stats, const platform_perf_counters* counters)
+{
+    for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+    {
+        frame_stats->report_counters.values[counter] += counters->values[counter];
+    }
+}
+
+void frame_stats_record_input_latency(frame_stats* frame_stats, f64 seconds)
+{
+    frame_stats->input_latencies[frame_stats->input_latency_count % FRAME_STATS_WINDOW_SIZE] = seconds;
+    frame_stats->input_latency_count++;
+}
+
+void frame_stats_end_frame(frame_stats* frame_stats)
+{
+    f64 frame_seconds = frame_stats->current[FRAME_STATS_PHASE_FRAME];
+
+    /** without a target the first frame has no reference, it only seeds the smoothed frame time */
+    f64 reference_seconds = frame_stats->config.target_frame_seconds;
+    if (reference_seconds <= 0.0)
+    {
+        reference_seconds = frame_stats->smoothed_frame_seconds;
+    }
+    if (reference_seconds > 0.0 && frame_seconds > frame_stats->config.hitch_factor * reference_seconds)
+    {
+        frame_stats->hitch_count++;
+        frame_stats->report_hitch_count++;
+    }
+
+    if (frame_stats->frame_count == 0)
+    {
+        frame_stats->smoothed_frame_seconds = frame_seconds;
+    }
+    else
+    {
+        frame_stats->smoothed_frame_seconds += (frame_seconds - frame_stats->smoothed_frame_seconds) * FRAME_STATS_SMOOTHING;
+    }
+
+    s64 slot = frame_stats->frame_count % FRAME_STATS_WINDOW_SIZE;
+    for (s32 phase = 0; phase < FRAME_STATS_PHASE_COUNT; ++phase)
+    {
+        frame_stats->durations[phase][slot] = frame_stats->current[phase];
+        frame_stats->current[phase] = 0.0;
+    }
+    frame_stats->frame_count++;
+
+    if (frame_stats->config.report_interval_seconds > 0.0)
+    {
+        f64 now = platform_get_absolute_time();
+        if (now - frame_stats->last_report_time >= frame_stats->config.report_interval_seconds)
+        {
+            frame_stats_log(frame_stats);
+            frame_stats->last_report_time = now;
+        }
+    }
+}
+
+/** `count` is how many samples were ever written to the `window` ring */
+static frame_stats_summary frame_stats_summarize_window(const f64* window, s64 count)
+{
+    frame_stats_summary summary = {};
+    summary.sample_count = std::min<s64>(count, FRAME_STATS_WINDOW_SIZE);
+    if (summary.sample_count == 0)
+    {
+        return summary;
+    }
+
+    f64 samples[FRAME_STATS_WINDOW_SIZE];
+    f64 sum = 0.0;
+    for (s64 sample_idx = 0; sample_idx < summary.sample_count; ++sample_idx)
+    {
+        samples[sample_idx] = window[sample_idx];
+        sum += samples[sample_idx];
+    }
+    std::sort(samples, samples + summary.sample_count);
+
+    /** linear interpolation between the closest ranks */
+    auto percentile = [&samples, &summary](f64 p) -> f64
+    {
+        f64 rank = p * (summary.sample_count - 1);
+        s64 lower = (s64)rank;
+        s64 upper = (lower + 1 < summary.sample_count) ? lower + 1 : lower;
+        f64 fraction = rank - lower;
+        return samples[lower] + (samples[upper] - samples[lower]) * fraction;
+    };
+
+    summary.min = samples[0];
+    summary.max = samples[summary.sample_count - 1];
+    summary.avg = sum / summary.sample_count;
+    summary.p50 = percentile(0.50);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    return summary;
+}
+
+frame_stats_summary frame_stats_summarize(const frame_stats* frame_stats, frame_stats_phase phase)
+{
+    return frame_stats_summarize_window(frame_stats->durations[phase], frame_stats->frame_count);
+}
+
+frame_stats_summary frame_stats_summarize_input_latency(const frame_stats* frame_stats)
+{
+    return frame_stats_summarize_window(frame_stats->input_latencies, frame_stats->input_latency_count);
+}
+
+void frame_stats_log(frame_stats* frame_stats)
+{
+    for (s32 phase = 0; phase < FRAME_STATS_PHASE_COUNT; ++phase)
+    {
+        frame_stats_summary summary = frame_stats_summarize(frame_stats, (frame_stats_phase)phase);
+        if (summary.max <= 0.0)
+        {
+            // no frame recorded yet
+            continue;
+        }
+
+        WINFO("%-8s ms min %.2f avg %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f (%lld frames)",
+              phase_names[phase], summary.min * 1000.0, summary.avg * 1000.0, summary.p50 * 1000.0,
+              summary.p95 * 1000.0, summary.p99 * 1000.0, summary.max * 1000.0, (long long)summary.sample_count);
+    }
+
+    frame_stats_summary latency = frame_stats_summarize_input_latency(frame_stats);
+    if (latency.sample_count > 0)
+    {
+        WINFO("%-8s ms min %.2f avg %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f (%lld frames with input)",
+              "latency", latency.min * 1000.0, latency.avg * 1000.0, latency.p50 * 1000.0,
+              latency.p95 * 1000.0, latency.p99 * 1000.0, latency.max * 1000.0, (long long)latency.sample_count);
+    }
+
+    WINFO("hitches %lld since the last report, %lld total",
+          (long long)frame_stats->report_hitch_count, (long long)frame_stats->hitch_count);
+    frame_stats->report_hitch_count = 0;
+
+    const u64* counters = frame_stats->report_counters.values;
+    f64 kilo_instructions = counters[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / 1000.0;
+    if (counters[PLATFORM_PERF_COUNTER_CYCLES] > 0 && kilo_instructions > 0.0)
+    {
+        WINFO("ipc %.2f, per 1000 instructions: llc misses %.2f branch misses %.2f dtlb misses %.2f",
+              (f64)counters[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / counters[PLATFORM_PERF_COUNTER_CYCLES],
+              counters[PLATFORM_PERF_COUNTER_LLC_MISSES] / kilo_instructions,
+              counters[PLATFORM_PERF_COUNTER_BRANCH_MISSES] / kilo_instructions,
+              counters[PLATFORM_PERF_COUNTER_DTLB_MISSES] / kilo_instructions);
+    }
+    frame_stats->report_counters = {};
+}
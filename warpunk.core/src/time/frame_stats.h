@@ -0,0 +1,88 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+
+/** frames the statistics are computed over */
+#define FRAME_STATS_WINDOW_SIZE 512
+
+typedef enum frame_stats_phase
+{
+    /** the whole frame, from the start of one frame to the start of the next */
+    FRAME_STATS_PHASE_FRAME,
+    FRAME_STATS_PHASE_UPDATE,
+    /** render_frame on the render thread, the application presents from it */
+    FRAME_STATS_PHASE_RENDER,
+    FRAME_STATS_PHASE_COUNT
+} frame_stats_phase;
+
+typedef struct frame_stats_config
+{
+    /** frame time the hitches are measured against, 0 uses the smoothed frame time instead */
+    f64 target_frame_seconds;
+    /** a frame taking more than this many times the reference is a hitch, 0 defaults to 2 */
+    f64 hitch_factor;
+    /** seconds between the logged summaries, 0 never logs */
+    f64 report_interval_seconds;
+} frame_stats_config;
+
+/** @brief Distribution of one phase over the window, in seconds. */
+typedef struct frame_stats_summary
+{
+    s64 sample_count;
+    f64 min;
+    f64 avg;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+    f64 max;
+} frame_stats_summary;
+
+typedef struct frame_stats
+{
+    frame_stats_config config;
+    /** ring of the last FRAME_STATS_WINDOW_SIZE frames per phase */
+    f64 durations[FRAME_STATS_PHASE_COUNT][FRAME_STATS_WINDOW_SIZE];
+    /** the phases of the frame that is still running, summed until frame_stats_end_frame */
+    f64 current[FRAME_STATS_PHASE_COUNT];
+    /** frames ever ended */
+    s64 frame_count;
+    /** exponentially smoothed frame time, the hitch reference without a target */
+    f64 smoothed_frame_seconds;
+    s64 hitch_count;
+    /** hitches since the last report */
+    s64 report_hitch_count;
+    /** ring of the event to present latency of the last FRAME_STATS_WINDOW_SIZE frames that processed input */
+    f64 input_latencies[FRAME_STATS_WINDOW_SIZE];
+    s64 input_latency_count;
+    /** hardware events counted since the last report, all zero if nothing sampled them */
+    platform_perf_counters report_counters;
+    f64 last_report_time;
+} frame_stats;
+
+/** */
+no_mangle warpunk_api void frame_stats_init(frame_stats* frame_stats, frame_stats_config config);
+
+/** Adds `seconds` to `phase` of the running frame, a phase can be recorded in several parts. */
+no_mangle warpunk_api void frame_stats_record(frame_stats* frame_stats, frame_stats_phase phase, f64 seconds);
+
+/** Adds hardware events counted during the frame, reported as IPC and misses per 1000 instructions. */
+no_mangle warpunk_api void frame_stats_record_counters(frame_stats* frame_stats, const platform_perf_counters* counters);
+
+/** Adds the time from the oldest input event a frame processed until the frame was presented. */
+no_mangle warpunk_api void frame_stats_record_input_latency(frame_stats* frame_stats, f64 seconds);
+
+/**
+ * Moves the running frame into the window and counts it as a hitch if it was too long.
+ * Logs a summary once the report interval passed.
+ */
+no_mangle warpunk_api void frame_stats_end_frame(frame_stats* frame_stats);
+
+/** Sorts a copy of the window, meant for reports rather than every frame. */
+no_mangle warpunk_api frame_stats_summary frame_stats_summarize(const frame_stats* frame_stats, frame_stats_phase phase);
+
+/** Like frame_stats_summarize, over the input latencies. */
+no_mangle warpunk_api frame_stats_summary frame_stats_summarize_input_latency(const frame_stats* frame_stats);
+
+/** Logs min/avg/percentiles/max of every recorded phase and the input latency, the hitches and the counters since the last report. */
+no_mangle warpunk_api void frame_stats_log(frame_stats* frame_stats);
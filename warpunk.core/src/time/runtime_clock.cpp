@@ -3,19 +3,19 @@
 
 void runtime_clock_update(runtime_clock* clock)
 {
-    if (clock->start_time != 0)
+    if (clock->start_ticks != 0)
     {
-        clock->elapsed = platform_get_absolute_time();
+        clock->elapsed = platform_ticks_to_seconds(platform_get_ticks() - clock->start_ticks);
     }
 }
 
 void runtime_clock_start(runtime_clock* clock)
 {
-    clock->start_time = platform_get_absolute_time();
+    clock->start_ticks = platform_get_ticks();
     clock->elapsed = 0;
 }
 
 void runtime_clock_stop(runtime_clock* clock)
 {
-    clock->start_time = 0;
+    clock->start_ticks = 0;
 }
\ No newline at end of file
@@ -8,9 +8,9 @@
 typedef struct runtime_clock
 {
     /**
-     * @brief Timestamp when the clock was started (in seconds).
+     * @brief Platform tick count when the clock was started, 0 while stopped.
      */
-    f64 start_time;
+    u64 start_ticks;
 
     /**
      * @brief Elapsed time since start (in seconds).
@@ -1,49 +1,922 @@
 #include "warpunk.core/src/utils/logger.h"
 #include "warpunk.core/src/platform/platform.h"
+#include "warpunk.core/src/memory/memory_tracker.h"
 
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define LOGGER_DEFAULT_RING_SIZE (64 * 1024)
+/** longer messages are truncated, the ring always holds at least two of them */
+#define LOGGER_MESSAGE_MAX_LENGTH 2048
+/** threads that can own a ring at the same time */
+#define LOGGER_MAX_RING_COUNT 64
+/** how long a thread waits for the writer before checking its full ring again */
+#define LOGGER_BLOCK_WAIT_SECONDS 0.0001
+#define LOGGER_DEFAULT_FILE_SIZE (16 * 1024 * 1024)
+#define LOGGER_FILE_PATH_MAX_LENGTH 256
+/** a crashing thread gives up waiting for a lock after this many tries, its owner may never release it */
+#define LOGGER_CRASH_LOCK_SPIN_COUNT (1 << 20)
+
+/**
+ * precedes every record in a ring. Without a site the payload is the formatted message without terminator,
+ * otherwise it holds the raw arguments of the site's format string.
+ */
+typedef struct log_record_header
+{
+    const log_site* site;
+    /** orders the records of different threads */
+    f64 timestamp;
+    u32 level;
+    u32 length;
+} log_record_header;
+
+/**
+ * Single producer single consumer byte ring, the owning thread appends records and the writer consumes them.
+ * `head` and `tail` only grow, records wrap around the end of `data`.
+ */
+typedef struct log_ring
+{
+    /** written by the writer */
+    alignas(CACHE_LINE_SIZE) u64 head;
+
+    /** written by the owning thread */
+    alignas(CACHE_LINE_SIZE) u64 tail;
+    u64 cached_head;
+
+    /** allocated by the first thread that owns the ring, kept for the next owners */
+    alignas(CACHE_LINE_SIZE) u8* data;
+    b8 is_owned;
+} log_ring;
+
+typedef struct logger_state
+{
+    logger_config config;
+    u64 ring_mask;
+    /** producers write to the rings while set */
+    b8 is_async;
+    /** the writer runs while set */
+    b8 is_running;
+    /** bumped on every startup, invalidates the rings threads still hold from before */
+    u32 generation;
+    thread_ticket writer_ticket;
+
+    /** bumped when a ring turns non-empty or the writer has to stop, the idle writer waits on it */
+    u32 wake_sequence;
+    /** set while the writer waits, spares the producers the wake call otherwise */
+    b8 is_writer_waiting;
+
+    /** highest ring index ever owned plus one, the writer only looks at these */
+    s32 ring_count;
+    log_ring rings[LOGGER_MAX_RING_COUNT];
+
+    s64 dropped_count;
+    /** dropped_count the writer reported last */
+    s64 reported_dropped_count;
+
+    /** held while the rings are drained, the crash handler drains them too */
+    b8 drain_lock;
+    /** set by the crash handler, the locks stop waiting for owners that may be dead */
+    b8 is_crashing;
+
+    /** held while appending to the file, fatal messages are written by their own thread */
+    b8 file_lock;
+    b8 has_file;
+    char file_path[LOGGER_FILE_PATH_MAX_LENGTH];
+    platform_mapped_file file;
+    s64 file_offset;
+    /** file lines carry the seconds since startup */
+    f64 start_time;
+} logger_state;
+
+/** the ring of one thread, handed back when the thread exits */
+typedef struct log_thread_state
+{
+    s32 ring_idx = -1;
+    u32 generation;
+    /** the writer itself always logs synchronously, it would wait for itself otherwise */
+    b8 is_writer;
+
+    ~log_thread_state();
+} log_thread_state;
+
+u64 log_filter = ~0ull;
 
 static PFN_console_write console_hook = 0;
+static logger_state state;
+static thread_local log_thread_state log_thread;
+
+static const char* level_strs[7] = {"[INFO]:    ", "[SUCCESS]: ", "[WARNING]: ", "[ERROR]:   ", "[FATAL]:   ", "[DEBUG]:   ", "[VERBOSE]: "};
+
+log_thread_state::~log_thread_state()
+{
+    if (ring_idx >= 0 && generation == __atomic_load_n(&state.generation, __ATOMIC_RELAXED))
+    {
+        // the writer keeps draining what the thread left behind
+        __atomic_store_n(&state.rings[ring_idx].is_owned, false, __ATOMIC_RELEASE);
+    }
+}
 
 void logger_console_write_hook_set(PFN_console_write hook)
 {
     console_hook = hook;
 }
 
+/** @returns false if the lock was not taken, only happens while crashing. */
+static b8 logger_lock(b8* lock)
+{
+    s64 spin_count = 0;
+    while (__atomic_test_and_set(lock, __ATOMIC_ACQUIRE))
+    {
+        if (__atomic_load_n(&state.is_crashing, __ATOMIC_RELAXED) && ++spin_count > LOGGER_CRASH_LOCK_SPIN_COUNT)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void logger_unlock(b8* lock)
+{
+    __atomic_clear(lock, __ATOMIC_RELEASE);
+}
+
+// FILE
+
+/** file lock held. Moves every kept file up by one and starts an empty one at the configured path. */
+static void logger_file_rotate()
+{
+    platform_mapped_file_close(&state.file, state.file_offset);
+    state.file_offset = 0;
+    __atomic_store_n(&state.has_file, false, __ATOMIC_RELEASE);
+
+    char path[LOGGER_FILE_PATH_MAX_LENGTH + 16];
+    char new_path[LOGGER_FILE_PATH_MAX_LENGTH + 16];
+    if (state.config.file_count > 0)
+    {
+        snprintf(path, sizeof(path), "%s.%d", state.file_path, state.config.file_count);
+        platform_file_delete(path);
+        for (s32 file_idx = state.config.file_count - 1; file_idx >= 1; --file_idx)
+        {
+            snprintf(path, sizeof(path), "%s.%d", state.file_path, file_idx);
+            snprintf(new_path, sizeof(new_path), "%s.%d", state.file_path, file_idx + 1);
+            platform_file_rename(path, new_path);
+        }
+        snprintf(new_path, sizeof(new_path), "%s.1", state.file_path);
+        platform_file_rename(state.file_path, new_path);
+    }
+
+    __atomic_store_n(&state.has_file, platform_mapped_file_create(state.file_path, state.config.file_size, &state.file), __ATOMIC_RELEASE);
+}
+
+static void logger_file_append(f64 timestamp, const char* line, s64 length)
+{
+    char time_prefix[32];
+    s32 time_prefix_length = snprintf(time_prefix, sizeof(time_prefix), "%12.6f ", timestamp - state.start_time);
+
+    if (!logger_lock(&state.file_lock))
+    {
+        return;
+    }
+    if (state.has_file && state.file_offset + time_prefix_length + length > state.file.size)
+    {
+        logger_file_rotate();
+    }
+    if (state.has_file)
+    {
+        u8* dst = (u8 *)state.file.memory + state.file_offset;
+        platform_memory_copy(dst, time_prefix, time_prefix_length);
+        platform_memory_copy(dst + time_prefix_length, (void *)line, length);
+        state.file_offset += time_prefix_length + length;
+    }
+    logger_unlock(&state.file_lock);
+}
+
+static void logger_file_sync()
+{
+    if (!logger_lock(&state.file_lock))
+    {
+        return;
+    }
+    if (state.has_file)
+    {
+        platform_mapped_file_sync(&state.file);
+    }
+    logger_unlock(&state.file_lock);
+}
+
+/** adds the level prefix and the newline and hands the message to the console and the file */
+static void logger_write(log_level level, f64 timestamp, const char* message, s64 length, b8 is_console)
+{
+    char out_message[LOGGER_MESSAGE_MAX_LENGTH + 16];
+    s64 prefix_length = 11;
+    platform_memory_copy(out_message, (void *)level_strs[level], prefix_length);
+    platform_memory_copy(out_message + prefix_length, (void *)message, length);
+    out_message[prefix_length + length] = '\n';
+    out_message[prefix_length + length + 1] = '\0';
+
+    if (is_console)
+    {
+        if (console_hook)
+        {
+            console_hook(level, out_message);
+        }
+        else
+        {
+            platform_console_write(level, out_message);
+        }
+    }
+
+    if (__atomic_load_n(&state.has_file, __ATOMIC_ACQUIRE))
+    {
+        logger_file_append(timestamp, out_message, prefix_length + length + 1);
+    }
+}
+
+// DEFERRED FORMAT
+
+typedef struct log_arg_value
+{
+    log_arg_type type;
+    union
+    {
+        s64 s64_value;
+        u64 u64_value;
+        f64 f64_value;
+    };
+    const char* string;
+    u16 length;
+} log_arg_value;
+
+/** @returns false once every argument was read. */
+static b8 logger_args_next(const u8* args, s64 args_size, s64* offset, log_arg_value* out_value)
+{
+    if (*offset >= args_size)
+    {
+        return false;
+    }
+
+    out_value->type = (log_arg_type)args[*offset];
+    *offset += 1;
+    if (out_value->type == LOG_ARG_TYPE_STRING)
+    {
+        platform_memory_copy(&out_value->length, (void *)(args + *offset), sizeof(u16));
+        out_value->string = (const char *)args + *offset + sizeof(u16);
+        *offset += sizeof(u16) + out_value->length;
+        return true;
+    }
+
+    platform_memory_copy(&out_value->u64_value, (void *)(args + *offset), sizeof(u64));
+    *offset += sizeof(u64);
+    return true;
+}
+
+static s64 logger_arg_as_s64(const log_arg_value* value)
+{
+    switch (value->type)
+    {
+        case LOG_ARG_TYPE_F64: return (s64)value->f64_value;
+        case LOG_ARG_TYPE_STRING: return 0;
+        default: return value->s64_value;
+    }
+}
+
+static f64 logger_arg_as_f64(const log_arg_value* value)
+{
+    switch (value->type)
+    {
+        case LOG_ARG_TYPE_F64: return value->f64_value;
+        case LOG_ARG_TYPE_S64: return (f64)value->s64_value;
+        case LOG_ARG_TYPE_STRING: return 0.0;
+        default: return (f64)value->u64_value;
+    }
+}
+
+/** plain %d and %u are the most common conversions, they skip snprintf. @returns the length written. */
+static s32 logger_format_integer(char* dst, s64 remaining, u64 magnitude, b8 is_negative)
+{
+    char digits[24];
+    s32 digit_count = 0;
+    do
+    {
+        digits[digit_count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (is_negative)
+    {
+        digits[digit_count++] = '-';
+    }
+
+    s32 length = 0;
+    while (digit_count > 0 && length < remaining - 1)
+    {
+        dst[length++] = digits[--digit_count];
+    }
+    return length;
+}
+
+/**
+ * printf for recorded arguments. Every conversion is formatted on its own with the length modifier
+ * replaced by the one of the recorded 64 bit type. @returns the length written to `out`.
+ */
+static s64 logger_format_deferred(const char* format, const u8* args, s64 args_size, char* out, s64 capacity)
+{
+    s64 length = 0;
+    s64 args_offset = 0;
+    const char* cursor = format;
+    while (*cursor != '\0' && length < capacity - 1)
+    {
+        if (cursor[0] != '%')
+        {
+            out[length++] = *cursor++;
+            continue;
+        }
+        if (cursor[1] == '%')
+        {
+            out[length++] = '%';
+            cursor += 2;
+            continue;
+        }
+
+        // flags, width and precision are kept, '*' is replaced by its recorded value
+        char spec[32];
+        s32 spec_length = 0;
+        spec[spec_length++] = *cursor++;
+        while (*cursor != '\0' && strchr("-+ #0123456789.*", *cursor) != nullptr && spec_length < 24)
+        {
+            if (*cursor == '*')
+            {
+                log_arg_value value = {};
+                logger_args_next(args, args_size, &args_offset, &value);
+                spec_length += snprintf(spec + spec_length, sizeof(spec) - spec_length, "%d", (s32)logger_arg_as_s64(&value));
+                cursor++;
+                continue;
+            }
+            spec[spec_length++] = *cursor++;
+        }
+        while (*cursor != '\0' && strchr("hlLqjzt", *cursor) != nullptr)
+        {
+            cursor++;
+        }
+
+        char conversion = *cursor;
+        if (conversion == '\0')
+        {
+            break;
+        }
+        cursor++;
+
+        log_arg_value value = {};
+        if (!logger_args_next(args, args_size, &args_offset, &value))
+        {
+            continue;
+        }
+
+        char* dst = out + length;
+        s64 remaining = capacity - length;
+        s32 written = 0;
+        b8 is_plain = spec_length == 1;
+        if (is_plain && (conversion == 'd' || conversion == 'i'))
+        {
+            s64 integer = logger_arg_as_s64(&value);
+            length += logger_format_integer(dst, remaining, (integer < 0) ? 0 - (u64)integer : (u64)integer, integer < 0);
+            continue;
+        }
+        if (is_plain && conversion == 'u')
+        {
+            length += logger_format_integer(dst, remaining, (u64)logger_arg_as_s64(&value), false);
+            continue;
+        }
+        if (is_plain && conversion == 's' && value.type == LOG_ARG_TYPE_STRING)
+        {
+            s64 string_length = (value.length < remaining - 1) ? value.length : remaining - 1;
+            platform_memory_copy(dst, (void *)value.string, string_length);
+            length += string_length;
+            continue;
+        }
+
+        switch (conversion)
+        {
+            case 'd':
+            case 'i':
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, (long long)logger_arg_as_s64(&value));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = 'l';
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, (unsigned long long)logger_arg_as_s64(&value));
+                break;
+            case 'c':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, (s32)logger_arg_as_s64(&value));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, logger_arg_as_f64(&value));
+                break;
+            case 's':
+            {
+                char string[LOG_ARGS_MAX_SIZE];
+                u16 string_length = (value.type == LOG_ARG_TYPE_STRING) ? value.length : 0;
+                platform_memory_copy(string, (void *)value.string, string_length);
+                string[string_length] = '\0';
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, string);
+                break;
+            }
+            case 'p':
+                spec[spec_length++] = conversion;
+                spec[spec_length] = '\0';
+                written = snprintf(dst, remaining, spec, (void *)(uintptr_t)value.u64_value);
+                break;
+            default:
+                break;
+        }
+
+        if (written > 0)
+        {
+            length += (written < remaining) ? written : remaining - 1;
+        }
+    }
+
+    out[length] = '\0';
+    return length;
+}
+
+// RING
+
+static void logger_wake_writer()
+{
+    __atomic_fetch_add(&state.wake_sequence, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&state.is_writer_waiting, __ATOMIC_SEQ_CST))
+    {
+        platform_address_wake(&state.wake_sequence);
+    }
+}
+
+static void logger_ring_copy_in(log_ring* ring, u64 position, const void* src, u64 size)
+{
+    u64 offset = position & state.ring_mask;
+    u64 first_size = state.ring_mask + 1 - offset;
+    if (size <= first_size)
+    {
+        platform_memory_copy(ring->data + offset, (void *)src, size);
+        return;
+    }
+    platform_memory_copy(ring->data + offset, (void *)src, first_size);
+    platform_memory_copy(ring->data, (u8 *)src + first_size, size - first_size);
+}
+
+static void logger_ring_copy_out(log_ring* ring, u64 position, void* dst, u64 size)
+{
+    u64 offset = position & state.ring_mask;
+    u64 first_size = state.ring_mask + 1 - offset;
+    if (size <= first_size)
+    {
+        platform_memory_copy(dst, ring->data + offset, size);
+        return;
+    }
+    platform_memory_copy(dst, ring->data + offset, first_size);
+    platform_memory_copy((u8 *)dst + first_size, ring->data, size - first_size);
+}
+
+/** @returns the ring of the calling thread, claims a free one on the thread's first message. */
+static log_ring* logger_thread_ring()
+{
+    u32 generation = __atomic_load_n(&state.generation, __ATOMIC_ACQUIRE);
+    if (log_thread.ring_idx >= 0 && log_thread.generation == generation)
+    {
+        return &state.rings[log_thread.ring_idx];
+    }
+
+    for (s32 ring_idx = 0; ring_idx < LOGGER_MAX_RING_COUNT; ++ring_idx)
+    {
+        log_ring* ring = &state.rings[ring_idx];
+        b8 expected = false;
+        if (!__atomic_compare_exchange_n(&ring->is_owned, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            continue;
+        }
+
+        if (ring->data == nullptr)
+        {
+            u8* data = (u8 *)WALLOC(state.ring_mask + 1, MEMORY_TAG_LOGGING);
+            if (data == nullptr)
+            {
+                __atomic_store_n(&ring->is_owned, false, __ATOMIC_RELEASE);
+                return nullptr;
+            }
+            __atomic_store_n(&ring->data, data, __ATOMIC_RELEASE);
+        }
+
+        s32 ring_count = __atomic_load_n(&state.ring_count, __ATOMIC_RELAXED);
+        while (ring_count <= ring_idx &&
+               !__atomic_compare_exchange_n(&state.ring_count, &ring_count, ring_idx + 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+        }
+
+        log_thread.ring_idx = ring_idx;
+        log_thread.generation = generation;
+        return ring;
+    }
+
+    // more logging threads than rings, the caller writes synchronously
+    return nullptr;
+}
+
+/** @returns false if the record was dropped. */
+static b8 logger_ring_push(log_ring* ring, const log_record_header* header, const void* payload)
+{
+    u64 capacity = state.ring_mask + 1;
+    u64 record_size = sizeof(log_record_header) + header->length;
+    u64 tail = ring->tail;
+    while (tail + record_size - ring->cached_head > capacity)
+    {
+        ring->cached_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail + record_size - ring->cached_head <= capacity)
+        {
+            break;
+        }
+
+        if (state.config.overflow_policy == LOG_OVERFLOW_POLICY_DROP)
+        {
+            __atomic_fetch_add(&state.dropped_count, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        platform_sleep(LOGGER_BLOCK_WAIT_SECONDS);
+    }
+
+    logger_ring_copy_in(ring, tail, header, sizeof(log_record_header));
+    if (header->length > 0)
+    {
+        logger_ring_copy_in(ring, tail + sizeof(log_record_header), payload, header->length);
+    }
+    __atomic_store_n(&ring->tail, tail + record_size, __ATOMIC_RELEASE);
+
+    // the writer may have gone idle on the empty ring, it drains what it finds after waking
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->head, __ATOMIC_RELAXED) == tail)
+    {
+        logger_wake_writer();
+    }
+    return true;
+}
+
+// WRITER
+
+/**
+ * writer only, or the crashing thread. A crash drain only copies the records into the file, the console
+ * writes can block on locks the dead threads hold.
+ * @returns the number of records written.
+ */
+static s64 logger_drain(b8 is_crash)
+{
+    s64 record_count = 0;
+    u8 payload[LOGGER_MESSAGE_MAX_LENGTH];
+    char message[LOGGER_MESSAGE_MAX_LENGTH];
+
+    // the records that were in the rings when the drain started, merged by timestamp
+    u64 heads[LOGGER_MAX_RING_COUNT];
+    u64 tails[LOGGER_MAX_RING_COUNT];
+    log_record_header next_headers[LOGGER_MAX_RING_COUNT];
+    s32 ring_count = __atomic_load_n(&state.ring_count, __ATOMIC_ACQUIRE);
+    for (s32 ring_idx = 0; ring_idx < ring_count; ++ring_idx)
+    {
+        log_ring* ring = &state.rings[ring_idx];
+        heads[ring_idx] = ring->head;
+        tails[ring_idx] = heads[ring_idx];
+        if (__atomic_load_n(&ring->data, __ATOMIC_ACQUIRE) != nullptr)
+        {
+            tails[ring_idx] = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        }
+        if (heads[ring_idx] != tails[ring_idx])
+        {
+            logger_ring_copy_out(ring, heads[ring_idx], &next_headers[ring_idx], sizeof(log_record_header));
+        }
+    }
+
+    while (true)
+    {
+        s32 oldest_ring_idx = -1;
+        for (s32 ring_idx = 0; ring_idx < ring_count; ++ring_idx)
+        {
+            if (heads[ring_idx] != tails[ring_idx] &&
+                (oldest_ring_idx < 0 || next_headers[ring_idx].timestamp < next_headers[oldest_ring_idx].timestamp))
+            {
+                oldest_ring_idx = ring_idx;
+            }
+        }
+        if (oldest_ring_idx < 0)
+        {
+            break;
+        }
+
+        log_ring* ring = &state.rings[oldest_ring_idx];
+        log_record_header header = next_headers[oldest_ring_idx];
+        u64 head = heads[oldest_ring_idx];
+        logger_ring_copy_out(ring, head + sizeof(header), payload, header.length);
+        // hand the space back before the slow console write, a blocked thread can continue right away
+        head += sizeof(header) + header.length;
+        heads[oldest_ring_idx] = head;
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        if (head != tails[oldest_ring_idx])
+        {
+            logger_ring_copy_out(ring, head, &next_headers[oldest_ring_idx], sizeof(log_record_header));
+        }
+
+        if (header.site != nullptr)
+        {
+            s64 length = logger_format_deferred(header.site->format, payload, header.length, message, sizeof(message));
+            logger_write((log_level)header.level, header.timestamp, message, length, !is_crash);
+        }
+        else
+        {
+            logger_write((log_level)header.level, header.timestamp, (const char *)payload, header.length, !is_crash);
+        }
+        record_count++;
+    }
+
+    s64 dropped_count = __atomic_load_n(&state.dropped_count, __ATOMIC_RELAXED);
+    if (dropped_count != state.reported_dropped_count)
+    {
+        char dropped_message[128];
+        s32 length = snprintf(dropped_message, sizeof(dropped_message), "%lld log messages dropped, the log rings are full.",
+                (long long)(dropped_count - state.reported_dropped_count));
+        logger_write(LOG_LEVEL_WARNING, platform_get_absolute_time(), dropped_message, length, !is_crash);
+        state.reported_dropped_count = dropped_count;
+    }
+    return record_count;
+}
+
+static void logger_writer_main([[maybe_unused]] void* arg)
+{
+    log_thread.is_writer = true;
+    while (__atomic_load_n(&state.is_running, __ATOMIC_ACQUIRE))
+    {
+        // read before the rings, a record pushed after the drain looked at them changes it
+        u32 wake_sequence = __atomic_load_n(&state.wake_sequence, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        logger_lock(&state.drain_lock);
+        s64 record_count = logger_drain(false);
+        logger_unlock(&state.drain_lock);
+        if (record_count == 0)
+        {
+            __atomic_store_n(&state.is_writer_waiting, true, __ATOMIC_SEQ_CST);
+            platform_address_wait(&state.wake_sequence, wake_sequence, -1.0);
+            __atomic_store_n(&state.is_writer_waiting, false, __ATOMIC_RELAXED);
+        }
+    }
+
+    logger_lock(&state.drain_lock);
+    logger_drain(false);
+    logger_unlock(&state.drain_lock);
+}
+
+/**
+ * Runs on the crashing thread. What the other threads still hold in their rings goes to the file before
+ * the process dies. The writer is only waited for briefly, without the drain lock the rings are left alone
+ * unless the crashing thread is the writer itself.
+ */
+static void logger_crash_handler([[maybe_unused]] s32 signal)
+{
+    __atomic_store_n(&state.is_crashing, true, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&state.is_async, __ATOMIC_ACQUIRE))
+    {
+        if (logger_lock(&state.drain_lock))
+        {
+            logger_drain(true);
+            logger_unlock(&state.drain_lock);
+        }
+        else if (log_thread.is_writer)
+        {
+            // the writer crashed inside a drain, nobody else touches the heads
+            logger_drain(true);
+        }
+    }
+    logger_file_sync();
+}
+
+b8 logger_startup(logger_config config)
+{
+    if (config.ring_size <= 0)
+    {
+        config.ring_size = LOGGER_DEFAULT_RING_SIZE;
+    }
+
+    u64 min_ring_size = 2 * (sizeof(log_record_header) + LOGGER_MESSAGE_MAX_LENGTH);
+    u64 ring_size = 1;
+    while (ring_size < (u64)config.ring_size || ring_size < min_ring_size)
+    {
+        ring_size *= 2;
+    }
+
+    if (config.file_size <= 0)
+    {
+        config.file_size = LOGGER_DEFAULT_FILE_SIZE;
+    }
+    // the longest line has to fit into an empty file
+    if (config.file_size < 16 * LOGGER_MESSAGE_MAX_LENGTH)
+    {
+        config.file_size = 16 * LOGGER_MESSAGE_MAX_LENGTH;
+    }
+
+    state.config = config;
+    state.ring_mask = ring_size - 1;
+    state.dropped_count = 0;
+    state.reported_dropped_count = 0;
+    state.start_time = platform_get_absolute_time();
+
+    if (config.file_path != nullptr)
+    {
+        snprintf(state.file_path, sizeof(state.file_path), "%s", config.file_path);
+        state.file_offset = 0;
+        if (!platform_mapped_file_create(state.file_path, config.file_size, &state.file))
+        {
+            WWARNING("Failed to create the log file %s.", state.file_path);
+        }
+        else
+        {
+            __atomic_store_n(&state.has_file, true, __ATOMIC_RELEASE);
+        }
+    }
+    platform_register_crash_handler(logger_crash_handler);
+    __atomic_store_n(&state.ring_count, 0, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&state.generation, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&state.is_running, true, __ATOMIC_RELEASE);
+
+    platform_threading_job job = {};
+    job.function = logger_writer_main;
+    if (!platform_threadpool_add(&job, 1, &state.writer_ticket))
+    {
+        __atomic_store_n(&state.is_running, false, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    __atomic_store_n(&state.is_async, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+void logger_shutdown()
+{
+    if (__atomic_load_n(&state.is_async, __ATOMIC_ACQUIRE))
+    {
+        __atomic_store_n(&state.is_async, false, __ATOMIC_RELEASE);
+        __atomic_store_n(&state.is_running, false, __ATOMIC_RELEASE);
+        logger_wake_writer();
+        platform_threadpool_sync(state.writer_ticket, 0.0);
+
+        for (s32 ring_idx = 0; ring_idx < LOGGER_MAX_RING_COUNT; ++ring_idx)
+        {
+            log_ring* ring = &state.rings[ring_idx];
+            WFREE(ring->data);
+            *ring = {};
+        }
+    }
+
+    platform_register_crash_handler(nullptr);
+    logger_lock(&state.file_lock);
+    if (state.has_file)
+    {
+        __atomic_store_n(&state.has_file, false, __ATOMIC_RELEASE);
+        platform_mapped_file_close(&state.file, state.file_offset);
+    }
+    logger_unlock(&state.file_lock);
+}
+
+void logger_flush()
+{
+    if (!__atomic_load_n(&state.is_async, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    s32 ring_count = __atomic_load_n(&state.ring_count, __ATOMIC_ACQUIRE);
+    for (s32 ring_idx = 0; ring_idx < ring_count; ++ring_idx)
+    {
+        log_ring* ring = &state.rings[ring_idx];
+        u64 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) < tail)
+        {
+            platform_sleep(LOGGER_BLOCK_WAIT_SECONDS);
+        }
+    }
+}
+
+void logger_filter_set(log_category category, log_level level, b8 enabled)
+{
+    if (enabled)
+    {
+        __atomic_fetch_or(&log_filter, LOG_FILTER_BIT(category, level), __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_and(&log_filter, ~LOG_FILTER_BIT(category, level), __ATOMIC_RELAXED);
+    }
+}
+
+void logger_filter_set_category(log_category category, u8 level_mask)
+{
+    u64 category_bits = 0xFFull << (category * 8);
+    u64 filter = __atomic_load_n(&log_filter, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&log_filter, &filter, (filter & ~category_bits) | ((u64)level_mask << (category * 8)),
+                true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+s64 logger_dropped_count()
+{
+    return __atomic_load_n(&state.dropped_count, __ATOMIC_RELAXED);
+}
+
 void _log_output(log_level level, const char* message, ...)
 {
-    const char* level_strs[7] = {"[INFO]:    ", "[SUCCESS]: ", "[WARNING]: ", "[ERROR]:   ", "[FATAL]:   ", "[DEBUG]:   ", "[VERBOSE]: "};
+    char formatted_message[LOGGER_MESSAGE_MAX_LENGTH];
 
-    // TODO: use string in the future 
-    char formatted_message[2048]; 
-    
     __builtin_va_list arg_ptr;
     va_start(arg_ptr, message);
-    vsnprintf(formatted_message, sizeof(formatted_message), message, arg_ptr);
+    s32 length = vsnprintf(formatted_message, sizeof(formatted_message), message, arg_ptr);
     va_end(arg_ptr);
-    
-    char out_message[2048]; 
-    snprintf(out_message, sizeof(out_message), "%s%s\n", level_strs[level], formatted_message);
-
-    if (console_hook) 
+    if (length < 0)
     {
-        console_hook(level, out_message);
-    } 
-    else 
+        return;
+    }
+    if (length >= LOGGER_MESSAGE_MAX_LENGTH)
     {
-        platform_console_write(level, out_message);
+        length = LOGGER_MESSAGE_MAX_LENGTH - 1;
     }
 
-    if (level == LOG_LEVEL_FATAL) 
+    if (__atomic_load_n(&state.is_async, __ATOMIC_ACQUIRE) && !log_thread.is_writer)
     {
+        log_ring* ring = logger_thread_ring();
+        if (level != LOG_LEVEL_FATAL && ring != nullptr)
+        {
+            log_record_header header = { nullptr, platform_get_absolute_time(), (u32)level, (u32)length };
+            logger_ring_push(ring, &header, formatted_message);
+            return;
+        }
+
+        // keeps the order with the messages of this thread that are still in the rings
+        logger_flush();
+    }
+
+    logger_write(level, platform_get_absolute_time(), formatted_message, length, true);
+
+    if (level == LOG_LEVEL_FATAL)
+    {
+        logger_file_sync();
         //warpunk_debug_break();
     }
 }
 
-void report_assertion_failure(const char* expression, const char* message, const char* file, s32 line) 
+void _log_output_deferred(const log_site* site, const u8* args, s64 args_size)
 {
-    _log_output(LOG_LEVEL_FATAL, "Assertion Failure: %s, message: '%s', [file:line]: %s:%d\n", expression, message, file, line);
+    if (__atomic_load_n(&state.is_async, __ATOMIC_ACQUIRE) && !log_thread.is_writer)
+    {
+        log_ring* ring = logger_thread_ring();
+        if (site->level != LOG_LEVEL_FATAL && ring != nullptr)
+        {
+            log_record_header header = { site, platform_get_absolute_time(), (u32)site->level, (u32)args_size };
+            logger_ring_push(ring, &header, args);
+            return;
+        }
+
+        // keeps the order with the messages of this thread that are still in the rings
+        logger_flush();
+    }
+
+    char formatted_message[LOGGER_MESSAGE_MAX_LENGTH];
+    s64 length = logger_format_deferred(site->format, args, args_size, formatted_message, sizeof(formatted_message));
+    logger_write(site->level, platform_get_absolute_time(), formatted_message, length, true);
+
+    if (site->level == LOG_LEVEL_FATAL)
+    {
+        logger_file_sync();
+    }
 }
 
+void report_assertion_failure(const char* expression, const char* message, const char* file, s32 line)
+{
+    _log_output(LOG_LEVEL_FATAL, "Assertion Failure: %s, message: '%s', [file:line]: %s:%d\n", expression, message, file, line);
+}
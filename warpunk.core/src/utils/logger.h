@@ -2,6 +2,9 @@
 
 #include "warpunk.core/src/defines.h"
 
+#include <string.h>
+#include <type_traits>
+
 /** @brief Enables logging for informational messages */
 #define LOG_INFO_ENABLED 1
 /** @brief Enables logging for success messages */
@@ -16,6 +19,13 @@
 #define LOG_DEBUG_ENABLED 1
 /** @brief Enables logging for verbose messages (very detailed logs) */
 #define LOG_VERBOSE_ENABLED 1
+/**
+ * @brief Log macros record the format string's address and the raw arguments and leave the formatting
+ * to the writer thread. 0 formats on the calling thread.
+ */
+#ifndef LOG_DEFERRED_FORMAT
+#define LOG_DEFERRED_FORMAT 1
+#endif
 
 /** 
  * @brief Enumeration of log levels used to categorize log messages by severity or purpose.
@@ -31,6 +41,49 @@ typedef enum log_level
     LOG_LEVEL_VERBOSE = 6,
 } log_level;
 
+/** @brief Subsystem a message belongs to, every category can be filtered per level at runtime. */
+typedef enum log_category
+{
+    LOG_CATEGORY_GENERAL,
+    LOG_CATEGORY_PLATFORM,
+    LOG_CATEGORY_MEMORY,
+    LOG_CATEGORY_RENDERER,
+    LOG_CATEGORY_INPUT,
+    LOG_CATEGORY_APPLICATION,
+
+    LOG_CATEGORY_COUNT
+} log_category;
+
+/** one bit per category and level, so a message is filtered with a single load and test */
+#define LOG_FILTER_BIT(category, level) (1ull << ((category) * 8 + (level)))
+
+static_assert(LOG_CATEGORY_COUNT <= 8, "log_filter holds 8 levels for at most 8 categories");
+
+/** Bits set with LOG_FILTER_BIT pass the filter, all of them are set at startup. */
+no_mangle warpunk_api u64 log_filter;
+
+/** What a thread does when its log ring is full. */
+typedef enum log_overflow_policy
+{
+    /** the message is discarded and counted, the writer reports the count */
+    LOG_OVERFLOW_POLICY_DROP,
+    /** the thread waits for the writer to make room */
+    LOG_OVERFLOW_POLICY_BLOCK,
+} log_overflow_policy;
+
+typedef struct logger_config
+{
+    /** bytes of every thread's ring, rounded up to a power of two */
+    s64 ring_size;
+    log_overflow_policy overflow_policy;
+    /** file the writer appends every message to next to the console, nullptr writes no file */
+    const char* file_path;
+    /** bytes preallocated and mapped per log file, a full file moves to `file_path`.1 */
+    s64 file_size;
+    /** rotated files kept next to the current one, the oldest is deleted */
+    s32 file_count;
+} logger_config;
+
 /**
  * @brief Function pointer type for a custom console write function.
  * @param level The severity level of the message
@@ -45,6 +98,34 @@ typedef void (*PFN_console_write)(log_level level, const char* message);
  */
 no_mangle warpunk_api void logger_console_write_hook_set(PFN_console_write hook);
 
+/**
+ * Moves output to a writer thread. Every logging thread gets its own lock free ring on its first message,
+ * the caller only formats the message and copies it into the ring. Before startup and after shutdown
+ * messages are written synchronously. Fatal messages are always written synchronously, after everything
+ * the calling thread logged before them, and the log file is synced to disk.
+ * With a log file, the messages are copied into a mapped, preallocated file, so a crash loses nothing the
+ * writer already handled. A fatal signal drains the rings into the file before the process dies.
+ */
+no_mangle warpunk_api b8 logger_startup(logger_config config);
+
+/**
+ * Writes what is left in the rings, stops the writer and cuts the log file to its content.
+ * The other threads must have stopped logging.
+ */
+no_mangle warpunk_api void logger_shutdown();
+
+/** Blocks until every message logged before the call was written. */
+no_mangle warpunk_api void logger_flush();
+
+/** @returns the number of messages discarded by LOG_OVERFLOW_POLICY_DROP since startup. */
+no_mangle warpunk_api s64 logger_dropped_count();
+
+/** Enables or disables one level of a category. */
+no_mangle warpunk_api void logger_filter_set(log_category category, log_level level, b8 enabled);
+
+/** Enables the levels of a category whose bit is set in `level_mask`, bit n is log_level n. */
+no_mangle warpunk_api void logger_filter_set_category(log_category category, u8 level_mask);
+
 /**
  * @brief Internal logging function that handles formatted log output.
  * Accepts a variable number of arguments similar to printf.
@@ -53,10 +134,141 @@ no_mangle warpunk_api void logger_console_write_hook_set(PFN_console_write hook)
  */
 no_mangle warpunk_api void _log_output(log_level level, const char* message, ...);
 
+/** @brief Identifies a log statement, the deferred records only carry its address. */
+typedef struct log_site
+{
+    const char* format;
+    log_category category;
+    log_level level;
+} log_site;
+
+typedef enum log_arg_type : u8
+{
+    LOG_ARG_TYPE_S64,
+    LOG_ARG_TYPE_U64,
+    LOG_ARG_TYPE_F64,
+    LOG_ARG_TYPE_POINTER,
+    /** followed by a u16 length and the characters without terminator */
+    LOG_ARG_TYPE_STRING,
+} log_arg_type;
+
+/** bytes of arguments a deferred record carries, longer strings are truncated */
+#define LOG_ARGS_MAX_SIZE 512
+
+/** @brief Raw arguments of a deferred record, every argument is a log_arg_type followed by its value. */
+typedef struct log_args
+{
+    s64 size;
+    u8 data[LOG_ARGS_MAX_SIZE];
+} log_args;
+
+/**
+ * @brief Internal logging function for the deferred records, formats `site->format` with the recorded
+ * arguments on the writer thread, or right away while the logger is not started.
+ */
+no_mangle warpunk_api void _log_output_deferred(const log_site* site, const u8* args, s64 args_size);
+
+template<typename T>
+inline void log_args_add_raw(log_args* args, log_arg_type type, T value)
+{
+    if (args->size + 1 + (s64)sizeof(T) > LOG_ARGS_MAX_SIZE)
+    {
+        return;
+    }
+    args->data[args->size] = type;
+    memcpy(args->data + args->size + 1, &value, sizeof(T));
+    args->size += 1 + sizeof(T);
+}
+
+inline void log_args_add_string(log_args* args, const char* value)
+{
+    if (value == nullptr)
+    {
+        value = "(null)";
+    }
+
+    s64 free_size = LOG_ARGS_MAX_SIZE - args->size - 1 - (s64)sizeof(u16);
+    if (free_size < 0)
+    {
+        return;
+    }
+    u16 length = (u16)strnlen(value, (u64)free_size);
+    args->data[args->size] = LOG_ARG_TYPE_STRING;
+    memcpy(args->data + args->size + 1, &length, sizeof(length));
+    memcpy(args->data + args->size + 1 + sizeof(length), value, length);
+    args->size += 1 + sizeof(length) + length;
+}
+
+/** Records one argument, every type printf accepts is widened to 64 bits. Strings are copied. */
+template<typename T>
+inline void log_args_add(log_args* args, T value)
+{
+    if constexpr (std::is_same_v<T, char*> || std::is_same_v<T, const char*>)
+    {
+        log_args_add_string(args, value);
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        log_args_add_raw(args, LOG_ARG_TYPE_F64, (f64)value);
+    }
+    else if constexpr (std::is_enum_v<T> || (std::is_integral_v<T> && std::is_signed_v<T>))
+    {
+        log_args_add_raw(args, LOG_ARG_TYPE_S64, (s64)value);
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+        log_args_add_raw(args, LOG_ARG_TYPE_U64, (u64)value);
+    }
+    else
+    {
+        static_assert(std::is_pointer_v<T> || std::is_null_pointer_v<T>, "log arguments have to be numbers, strings or pointers");
+        log_args_add_raw(args, LOG_ARG_TYPE_POINTER, (u64)(uintptr_t)value);
+    }
+}
+
+template<typename... Args>
+inline void _log_deferred(const log_site* site, Args... values)
+{
+    if constexpr (sizeof...(Args) == 0)
+    {
+        _log_output_deferred(site, nullptr, 0);
+    }
+    else
+    {
+        log_args args;
+        args.size = 0;
+        (log_args_add(&args, values), ...);
+        _log_output_deferred(site, args.data, args.size);
+    }
+}
+
+#if LOG_DEFERRED_FORMAT == 1
+/** @brief Logs `message` in `category` if the level passes the runtime filter, formatted by the writer. */
+#define WLOG(category, level, message, ...)                                              \
+    do                                                                                   \
+    {                                                                                    \
+        if (__atomic_load_n(&log_filter, __ATOMIC_RELAXED) & LOG_FILTER_BIT(category, level)) \
+        {                                                                                \
+            static const log_site _log_site = { message, category, level };             \
+            _log_deferred(&_log_site, ##__VA_ARGS__);                                    \
+        }                                                                                \
+    } while (0)
+#else
+/** @brief Logs `message` in `category` if the level passes the runtime filter. */
+#define WLOG(category, level, message, ...)                                              \
+    do                                                                                   \
+    {                                                                                    \
+        if (__atomic_load_n(&log_filter, __ATOMIC_RELAXED) & LOG_FILTER_BIT(category, level)) \
+        {                                                                                \
+            _log_output(level, message, ##__VA_ARGS__);                                  \
+        }                                                                                \
+    } while (0)
+#endif
+
 
 #if LOG_INFO_ENABLED == 1
 /** @brief Logs an informational message if enabled */
-#define WINFO(message, ...) _log_output(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+#define WINFO(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_INFO, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no informational messages */
 #define WINFO(message, ...)
@@ -64,7 +276,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_SUCCESS_ENABLED == 1
 /** @brief Logs a success message if enabled */
-#define WSUCCESS(message, ...) _log_output(LOG_LEVEL_SUCCESS, message, ##__VA_ARGS__);
+#define WSUCCESS(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_SUCCESS, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no success messages */
 #define WSUCCESS(message, ...)
@@ -72,7 +284,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_WARNING_ENABLED == 1
 /** @brief Logs a warning message if enabled */
-#define WWARNING(message, ...) _log_output(LOG_LEVEL_WARNING, message, ##__VA_ARGS__);
+#define WWARNING(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_WARNING, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no warning messages */
 #define WWARNING(message, ...)
@@ -80,7 +292,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_ERROR_ENABLED == 1
 /** @brief Logs an error message if enabled */
-#define WERROR(message, ...) _log_output(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
+#define WERROR(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no error messages */
 #define WERROR(message, ...)
@@ -88,7 +300,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_FATAL_ENABLED == 1
 /** @brief Logs a fatal error message if enabled */
-#define WFATAL(message, ...) _log_output(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
+#define WFATAL(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no fatal error messages */
 #define WFATAL(message, ...)
@@ -96,7 +308,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_DEBUG_ENABLED == 1
 /** @brief Logs a debug message if enabled */
-#define WDEBUG(message, ...) _log_output(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#define WDEBUG(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no debug messages */
 #define WDEBUG(message, ...)
@@ -104,7 +316,7 @@ no_mangle warpunk_api void _log_output(log_level level, const char* message, ...
 
 #if LOG_VERBOSE_ENABLED == 1
 /** @brief Logs a verbose message if enabled */
-#define WVERBOSE(message, ...) _log_output(LOG_LEVEL_VERBOSE, message, ##__VA_ARGS__);
+#define WVERBOSE(message, ...) WLOG(LOG_CATEGORY_GENERAL, LOG_LEVEL_VERBOSE, message, ##__VA_ARGS__);
 #else
 /** @brief Disabled: Logs no verbose messages */
 #define WVERBOSE(message, ...)
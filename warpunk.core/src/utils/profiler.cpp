@@ -0,0 +1,247 @@
+#include "warpunk.core/src/utils/profiler.h"
+#include "warpunk.core/src/memory/memory_tracker.h"
+#include "warpunk.core/src/utils/logger.h"
+
+#include <stdio.h>
+
+#define PROFILER_DEFAULT_EVENTS_PER_THREAD (64 * 1024)
+/** threads that can record at the same time */
+#define PROFILER_MAX_BUFFER_COUNT 64
+
+/** @brief Events of one thread, the owner overwrites the oldest once it is full. */
+typedef struct profiler_buffer
+{
+    /** events ever recorded into the buffer, only grows until the profiler is cleared */
+    alignas(CACHE_LINE_SIZE) u64 event_count;
+    profiler_event* events;
+    b8 is_owned;
+} profiler_buffer;
+
+typedef struct profiler_state
+{
+    profiler_config config;
+    /** the trace starts at 0 */
+    u64 start_ticks;
+    /** bumped on every startup, invalidates the buffers threads still hold from before */
+    u32 generation;
+    /** highest buffer index ever owned plus one */
+    s32 buffer_count;
+    profiler_buffer buffers[PROFILER_MAX_BUFFER_COUNT];
+} profiler_state;
+
+/** the buffer of one thread, handed back when the thread exits */
+typedef struct profiler_thread_state
+{
+    s32 buffer_idx = -1;
+    u32 generation;
+
+    ~profiler_thread_state();
+} profiler_thread_state;
+
+b8 profiler_is_recording = false;
+b8 profiler_is_sampling_counters = false;
+
+static profiler_state state;
+static thread_local profiler_thread_state profiler_thread;
+
+profiler_thread_state::~profiler_thread_state()
+{
+    if (buffer_idx >= 0 && generation == __atomic_load_n(&state.generation, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&state.buffers[buffer_idx].is_owned, false, __ATOMIC_RELEASE);
+    }
+}
+
+/** @returns the buffer of the calling thread, claims a free one on the thread's first zone. */
+static profiler_buffer* profiler_thread_buffer()
+{
+    u32 generation = __atomic_load_n(&state.generation, __ATOMIC_ACQUIRE);
+    if (profiler_thread.buffer_idx >= 0 && profiler_thread.generation == generation)
+    {
+        return &state.buffers[profiler_thread.buffer_idx];
+    }
+
+    for (s32 buffer_idx = 0; buffer_idx < PROFILER_MAX_BUFFER_COUNT; ++buffer_idx)
+    {
+        profiler_buffer* buffer = &state.buffers[buffer_idx];
+        b8 expected = false;
+        if (!__atomic_compare_exchange_n(&buffer->is_owned, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            continue;
+        }
+
+        if (buffer->events == nullptr)
+        {
+            profiler_event* events = (profiler_event *)WALLOC(sizeof(profiler_event) * state.config.events_per_thread, MEMORY_TAG_PROFILER);
+            if (events == nullptr)
+            {
+                __atomic_store_n(&buffer->is_owned, false, __ATOMIC_RELEASE);
+                return nullptr;
+            }
+            __atomic_store_n(&buffer->events, events, __ATOMIC_RELEASE);
+        }
+
+        s32 buffer_count = __atomic_load_n(&state.buffer_count, __ATOMIC_RELAXED);
+        while (buffer_count <= buffer_idx &&
+               !__atomic_compare_exchange_n(&state.buffer_count, &buffer_count, buffer_idx + 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+        }
+
+        profiler_thread.buffer_idx = buffer_idx;
+        profiler_thread.generation = generation;
+        return buffer;
+    }
+
+    // more profiled threads than buffers, their zones are lost
+    return nullptr;
+}
+
+b8 profiler_startup(profiler_config config)
+{
+    if (config.events_per_thread <= 0)
+    {
+        config.events_per_thread = PROFILER_DEFAULT_EVENTS_PER_THREAD;
+    }
+
+    state.config = config;
+    state.start_ticks = platform_get_ticks();
+    __atomic_store_n(&state.buffer_count, 0, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&state.generation, 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&profiler_is_sampling_counters, config.sample_counters, __ATOMIC_RELAXED);
+    __atomic_store_n(&profiler_is_recording, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+void profiler_shutdown()
+{
+    __atomic_store_n(&profiler_is_recording, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&profiler_is_sampling_counters, false, __ATOMIC_RELAXED);
+    for (s32 buffer_idx = 0; buffer_idx < PROFILER_MAX_BUFFER_COUNT; ++buffer_idx)
+    {
+        profiler_buffer* buffer = &state.buffers[buffer_idx];
+        WFREE(buffer->events);
+        *buffer = {};
+    }
+}
+
+void profiler_record(const char* name, u64 start_ticks, u64 end_ticks, const platform_perf_counters* counters)
+{
+    if (!__atomic_load_n(&profiler_is_recording, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    profiler_buffer* buffer = profiler_thread_buffer();
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    u64 event_count = buffer->event_count;
+    profiler_event* event = &buffer->events[event_count % state.config.events_per_thread];
+    event->name = name;
+    event->start_ticks = start_ticks;
+    event->end_ticks = end_ticks;
+    event->has_counters = (counters != nullptr);
+    if (counters != nullptr)
+    {
+        event->counters = *counters;
+    }
+    __atomic_store_n(&buffer->event_count, event_count + 1, __ATOMIC_RELEASE);
+}
+
+void profiler_clear()
+{
+    s32 buffer_count = __atomic_load_n(&state.buffer_count, __ATOMIC_ACQUIRE);
+    for (s32 buffer_idx = 0; buffer_idx < buffer_count; ++buffer_idx)
+    {
+        __atomic_store_n(&state.buffers[buffer_idx].event_count, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/** writes `string` as a JSON string, the zone names are identifiers but function names can hold anything */
+static void profiler_write_json_string(FILE* file, const char* string)
+{
+    fputc('"', file);
+    for (const char* cursor = string; *cursor != '\0'; ++cursor)
+    {
+        if (*cursor == '"' || *cursor == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc(*cursor, file);
+    }
+    fputc('"', file);
+}
+
+/** the counters as the zone's args, the trace viewers show them when the zone is selected */
+static void profiler_write_counters(FILE* file, const platform_perf_counters* counters)
+{
+    const u64* values = counters->values;
+    f64 kilo_instructions = values[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / 1000.0;
+    fprintf(file, ",\"args\":{\"cycles\":%llu,\"instructions\":%llu,\"llc_misses\":%llu,\"branch_misses\":%llu,\"dtlb_misses\":%llu",
+            (unsigned long long)values[PLATFORM_PERF_COUNTER_CYCLES], (unsigned long long)values[PLATFORM_PERF_COUNTER_INSTRUCTIONS],
+            (unsigned long long)values[PLATFORM_PERF_COUNTER_LLC_MISSES], (unsigned long long)values[PLATFORM_PERF_COUNTER_BRANCH_MISSES],
+            (unsigned long long)values[PLATFORM_PERF_COUNTER_DTLB_MISSES]);
+    if (values[PLATFORM_PERF_COUNTER_CYCLES] > 0 && kilo_instructions > 0.0)
+    {
+        fprintf(file, ",\"ipc\":%.3f,\"llc_mpki\":%.3f,\"branch_mpki\":%.3f,\"dtlb_mpki\":%.3f",
+                (f64)values[PLATFORM_PERF_COUNTER_INSTRUCTIONS] / values[PLATFORM_PERF_COUNTER_CYCLES],
+                values[PLATFORM_PERF_COUNTER_LLC_MISSES] / kilo_instructions,
+                values[PLATFORM_PERF_COUNTER_BRANCH_MISSES] / kilo_instructions,
+                values[PLATFORM_PERF_COUNTER_DTLB_MISSES] / kilo_instructions);
+    }
+    fputc('}', file);
+}
+
+b8 profiler_export_chrome_trace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        WERROR("Failed to open %s for the profiler trace.", path);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"warpunk\"}}");
+
+    s64 exported_count = 0;
+    s32 buffer_count = __atomic_load_n(&state.buffer_count, __ATOMIC_ACQUIRE);
+    for (s32 buffer_idx = 0; buffer_idx < buffer_count; ++buffer_idx)
+    {
+        profiler_buffer* buffer = &state.buffers[buffer_idx];
+        profiler_event* events = __atomic_load_n(&buffer->events, __ATOMIC_ACQUIRE);
+        u64 event_count = __atomic_load_n(&buffer->event_count, __ATOMIC_ACQUIRE);
+        if (events == nullptr || event_count == 0)
+        {
+            continue;
+        }
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                buffer_idx, buffer_idx);
+
+        u64 capacity = (u64)state.config.events_per_thread;
+        u64 first_event = (event_count > capacity) ? event_count - capacity : 0;
+        for (u64 event_idx = first_event; event_idx < event_count; ++event_idx)
+        {
+            profiler_event* event = &events[event_idx % capacity];
+            fprintf(file, ",\n{\"name\":");
+            profiler_write_json_string(file, event->name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    buffer_idx, platform_ticks_to_seconds(event->start_ticks - state.start_ticks) * 1e6,
+                    platform_ticks_to_seconds(event->end_ticks - event->start_ticks) * 1e6);
+            if (event->has_counters)
+            {
+                profiler_write_counters(file, &event->counters);
+            }
+            fputc('}', file);
+            exported_count++;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    WINFO("Wrote %lld profiler zones to %s.", (long long)exported_count, path);
+    return true;
+}
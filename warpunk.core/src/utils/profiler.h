@@ -0,0 +1,113 @@
+#pragma once
+
+#include "warpunk.core/src/defines.h"
+#include "warpunk.core/src/platform/platform.h"
+
+/** @brief Compiles the WPROFILE_* zones in, 0 removes them without a trace. */
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+typedef struct profiler_config
+{
+    /** zones every thread keeps, the oldest are overwritten once a thread recorded more */
+    s64 events_per_thread;
+    /** also reads the hardware counters around every zone, two system calls per zone */
+    b8 sample_counters;
+} profiler_config;
+
+/** @brief A finished zone, exported as a Chrome trace complete event. */
+typedef struct profiler_event
+{
+    /** must outlive the profiler, the zones use string literals */
+    const char* name;
+    /** platform ticks, converted to time on export */
+    u64 start_ticks;
+    u64 end_ticks;
+    /** counted inside the zone, only set if the counters were sampled */
+    b8 has_counters;
+    platform_perf_counters counters;
+} profiler_event;
+
+/** Set between startup and shutdown, the zones skip reading the clock while it is clear. */
+no_mangle warpunk_api b8 profiler_is_recording;
+
+/** Set while recording with profiler_config::sample_counters. */
+no_mangle warpunk_api b8 profiler_is_sampling_counters;
+
+/**
+ * Zones are recorded into a buffer per thread that only that thread writes to. A thread claims a buffer with
+ * its first zone and hands it back when it exits, the buffer index is the thread id in the trace.
+ * Nothing is recorded before startup.
+ */
+no_mangle warpunk_api b8 profiler_startup(profiler_config config);
+
+/** */
+no_mangle warpunk_api void profiler_shutdown();
+
+/**
+ * Records a zone that ran on the calling thread, used by the WPROFILE_* macros.
+ * `counters` are the hardware events counted inside the zone, nullptr if they were not sampled.
+ */
+no_mangle warpunk_api void profiler_record(const char* name, u64 start_ticks, u64 end_ticks, const platform_perf_counters* counters);
+
+/**
+ * Writes the recorded zones as Chrome trace event JSON, open it in chrome://tracing or ui.perfetto.dev.
+ * Zones recorded while exporting may be cut, export between frames or after the work finished.
+ */
+no_mangle warpunk_api b8 profiler_export_chrome_trace(const char* path);
+
+/** Forgets every recorded zone. */
+no_mangle warpunk_api void profiler_clear();
+
+/** @brief Records the time between its construction and the end of the enclosing scope. */
+typedef struct profiler_scope
+{
+    const char* name;
+    u64 start_ticks;
+    b8 has_counters;
+    platform_perf_counters start_counters;
+
+    profiler_scope(const char* name) : name(name)
+    {
+        has_counters = __atomic_load_n(&profiler_is_sampling_counters, __ATOMIC_RELAXED) && platform_perf_counters_read(&start_counters);
+        start_ticks = __atomic_load_n(&profiler_is_recording, __ATOMIC_RELAXED) ? platform_get_ticks() : 0;
+    }
+
+    ~profiler_scope()
+    {
+        if (start_ticks == 0)
+        {
+            return;
+        }
+
+        u64 end_ticks = platform_get_ticks();
+        platform_perf_counters counters;
+        if (has_counters && platform_perf_counters_read(&counters))
+        {
+            for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+            {
+                counters.values[counter] -= start_counters.values[counter];
+            }
+            profiler_record(name, start_ticks, end_ticks, &counters);
+        }
+        else
+        {
+            profiler_record(name, start_ticks, end_ticks, nullptr);
+        }
+    }
+} profiler_scope;
+
+#if PROFILER_ENABLED == 1
+#define WPROFILE_CONCAT_INNER(a, b) a##b
+#define WPROFILE_CONCAT(a, b) WPROFILE_CONCAT_INNER(a, b)
+/** @brief Profiles the rest of the enclosing scope as the zone `name`, a string literal. */
+#define WPROFILE_SCOPE(name) profiler_scope WPROFILE_CONCAT(_profiler_scope_, __LINE__)(name)
+/** @brief Profiles the rest of the enclosing function. */
+#define WPROFILE_FUNCTION() WPROFILE_SCOPE(__func__)
+#else
+/** @brief Disabled: profiles nothing */
+#define WPROFILE_SCOPE(name)
+/** @brief Disabled: profiles nothing */
+#define WPROFILE_FUNCTION()
+#endif
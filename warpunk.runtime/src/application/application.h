@@ -2,7 +2,24 @@
 
 #include <warpunk.core/src/defines.h>
 
-/** @brief Represents the core application interface with lifecycle callbacks. */
+/**
+ * @brief Everything render_frame needs from the simulation, filled by prepare_frame.
+ * The engine keeps two, so the next frame can be prepared while the previous one is rendered.
+ */
+typedef struct frame_packet
+{
+    u64 frame_index;
+    /** seconds between the updates of this frame and the previous one */
+    f64 delta_seconds;
+    /** application::frame_packet_size bytes for the application's own frame data, nullptr if the size is 0 */
+    void* data;
+} frame_packet;
+
+/** 
+ * @brief Represents the core application interface with lifecycle callbacks.
+ * update and prepare_frame of frame N+1 run on the main thread while render_frame of frame N runs on a render 
+ * thread, render_frame must only read its packet and not the state update changes.
+ */
 typedef struct application
 {
     /** @brief Called before system initialization to perform early setup. */
@@ -11,13 +28,16 @@ typedef struct application
     /** @brief Updates application state once per frame. */
     b8 (*update)(struct application* app);
 
-    /** @brief Prepares resources and state for rendering. */
-    b8 (*prepare_frame)(struct application* app);
+    /** @brief Copies what the frame renders from the simulation into `packet`. */
+    b8 (*prepare_frame)(struct application* app, frame_packet* packet);
 
-    /** @brief Executes all rendering operations for the current frame. */
-    b8 (*render_frame)(struct application* app);
+    /** @brief Executes all rendering operations for the frame in `packet`, runs on the render thread. */
+    b8 (*render_frame)(struct application* app, const frame_packet* packet);
 
     /** @brief Cleans up resources and shuts down the application. */
     b8 (*shutdown)(struct application* app);
+
+    /** @brief Bytes of application data in every frame packet. */
+    u64 frame_packet_size;
 } application;
 
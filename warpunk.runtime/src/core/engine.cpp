@@ -1,31 +1,213 @@
 #include "warpunk.runtime/src/core/engine.h"
+#include "warpunk.runtime/src/application/application.h"
 
+#include <warpunk.core/src/input_system/input_recording.h>
 #include <warpunk.core/src/input_system/input_system.h>
+#include <warpunk.core/src/memory/memory_system.h>
 #include <warpunk.core/src/platform/platform.h>
 #include <warpunk.core/src/renderer/renderer_backend.h>
+#include <warpunk.core/src/time/frame_pacer.h>
+#include <warpunk.core/src/time/frame_stats.h>
 #include <warpunk.core/src/time/runtime_clock.h>
+#include <warpunk.core/src/utils/logger.h>
+#include <warpunk.core/src/utils/profiler.h>
+
+#include <stdlib.h>
+
+/** how often the suspended loop wakes up without events */
+#define ENGINE_IDLE_WAKE_SECONDS 0.5
+
+/** frames in flight: one rendering, one being prepared */
+#define ENGINE_FRAME_SLOT_COUNT 2
+
+/** a frame packet and what the engine learns about it on the render thread */
+typedef struct engine_frame_slot
+{
+    frame_packet packet;
+    b8 is_rendered;
+    f64 render_seconds;
+    /** arrival of the oldest input event the frame processed, 0 if it had none */
+    u64 input_ticks;
+    /** when render_frame returned, the frame is on its way to the screen */
+    u64 present_ticks;
+} engine_frame_slot;
 
 typedef struct engine_state
 {
     application* app;
     b8 is_running;
+    /** hidden or unfocused, the loop sleeps until window events arrive */
     b8 is_suspended;
+    /** the first frame after a suspension starts a new schedule and is left out of the statistics */
+    b8 is_resuming;
+
+    /** frames started since engine_run, what recorded input is keyed by */
+    u64 frame_index;
+    /** oldest input event processed since the last frame started, carried into the next packet */
+    u64 pending_input_ticks;
+    engine_frame_slot frame_slots[ENGINE_FRAME_SLOT_COUNT];
+    /** the slot the render thread works on, nullptr while nothing renders */
+    engine_frame_slot* rendering_slot;
+    b8 is_render_threaded;
+    thread_ticket render_ticket;
 
     runtime_clock clock;
+    frame_stats frame_stats;
+    frame_pacer frame_pacer;
     f64 last_time;
+    f64 target_frame_seconds;
+    /** every frame simulates exactly this long while input is recorded or replayed, 0 uses the measured time */
+    f64 fixed_delta_seconds;
+
+    b8 is_recording_input;
+    input_recorder input_recorder;
+    /** live input is ignored while a recording replays */
+    b8 is_replaying_input;
+    input_player input_player;
 } engine_state;
 
 // TODO: heap alloc
 struct engine_state state = {};
 
+static void engine_on_window_state(b8 is_visible, b8 is_focused)
+{
+    b8 is_suspended = !is_visible || !is_focused;
+    if (is_suspended == state.is_suspended)
+    {
+        return;
+    }
+
+    state.is_suspended = is_suspended;
+    state.is_resuming = !is_suspended;
+    WINFO("%s the frame loop.", is_suspended ? "Suspending" : "Resuming");
+}
+
+/** the frame loop ends after the current frame, the platform is shut down with the engine */
+static void engine_on_window_close()
+{
+    WINFO("Window closed, shutting down.");
+    state.is_running = false;
+}
+
+static void engine_on_key(keycode keycode, b8 pressed)
+{
+    if (state.is_replaying_input)
+    {
+        return;
+    }
+    if (state.is_recording_input)
+    {
+        platform_event event = {};
+        event.type = PLATFORM_EVENT_TYPE_KEY;
+        event.key.keycode = keycode;
+        event.key.pressed = pressed;
+        input_recorder_record(&state.input_recorder, state.frame_index, &event);
+    }
+    input_system_process_key(keycode, pressed);
+}
+
+static void engine_on_mouse_button(mouse_button mouse_button, b8 pressed)
+{
+    if (state.is_replaying_input)
+    {
+        return;
+    }
+    if (state.is_recording_input)
+    {
+        platform_event event = {};
+        event.type = PLATFORM_EVENT_TYPE_MOUSE_BUTTON;
+        event.mouse_button.mouse_button = mouse_button;
+        event.mouse_button.pressed = pressed;
+        input_recorder_record(&state.input_recorder, state.frame_index, &event);
+    }
+    input_system_process_mouse_button(mouse_button, pressed);
+}
+
+static void engine_on_mouse_move(s16 x, s16 y)
+{
+    if (state.is_replaying_input)
+    {
+        return;
+    }
+    if (state.is_recording_input)
+    {
+        platform_event event = {};
+        event.type = PLATFORM_EVENT_TYPE_MOUSE_MOVE;
+        event.mouse_move.x = x;
+        event.mouse_move.y = y;
+        input_recorder_record(&state.input_recorder, state.frame_index, &event);
+    }
+    input_system_process_mouse_move(x, y);
+}
+
+static void engine_on_mouse_wheel(s32 delta)
+{
+    if (state.is_replaying_input)
+    {
+        return;
+    }
+    if (state.is_recording_input)
+    {
+        platform_event event = {};
+        event.type = PLATFORM_EVENT_TYPE_MOUSE_WHEEL;
+        event.mouse_wheel.delta = delta;
+        input_recorder_record(&state.input_recorder, state.frame_index, &event);
+    }
+    input_system_process_mouse_wheel(delta);
+}
+
 b8 engine_create(struct application* app)
 {
     state.is_running = true;
+    state.target_frame_seconds = 1.0 / 60;
+
+    // Logger
+    {
+        logger_config config = {};
+        config.ring_size = 64 * 1024;
+        config.overflow_policy = LOG_OVERFLOW_POLICY_DROP;
+        config.file_path = "warpunk.log";
+        config.file_size = 16 * 1024 * 1024;
+        config.file_count = 4;
+        if (!logger_startup(config))
+        {
+            WWARNING("Failed to start the log writer, logging synchronously.");
+        }
+    }
+
+    // Memory system
+    {
+        memory_system_config config = {};
+        config.frame_arena_size = 4 * 1024 * 1024;
+        config.scratch_arena_size = 256 * 1024;
+        if (!memory_system_startup(config))
+        {
+            WERROR("Failed to initialize memory system.");
+            return false;
+        }
+    }
+
+#if PROFILER_ENABLED == 1
+    // Profiler
+    {
+        profiler_config config = {};
+        config.events_per_thread = 64 * 1024;
+        if (!profiler_startup(config))
+        {
+            WWARNING("Failed to start the profiler.");
+        }
+    }
+#endif
 
     // Platform system
     {
         // TODO: config
-        if (!platform_startup())
+        platform_config config = {};
+        config.backend = (getenv("WARPUNK_HEADLESS") != nullptr) ? PLATFORM_BACKEND_HEADLESS : PLATFORM_BACKEND_AUTO;
+        config.window_width = 960;
+        config.window_height = 540;
+        config.use_input_thread = true;
+        if (!platform_startup(config))
         {
             WERROR("Failed to initialize platform system.");
             return false;
@@ -40,20 +222,53 @@ b8 engine_create(struct application* app)
             return false;
         }
 
-        platform_register_keyboard_event(input_system_process_key);
-        platform_register_mouse_button_event(input_system_process_mouse_button);
-        platform_register_mouse_move_event(input_system_process_mouse_move);
-        platform_register_mouse_wheel_event(input_system_process_mouse_wheel);
+        platform_register_keyboard_event(engine_on_key);
+        platform_register_mouse_button_event(engine_on_mouse_button);
+        platform_register_mouse_move_event(engine_on_mouse_move);
+        platform_register_mouse_wheel_event(engine_on_mouse_wheel);
+        platform_register_window_state_event(engine_on_window_state);
+        platform_register_window_close_event(engine_on_window_close);
+    }
+
+    // Input recording, both run at a fixed timestep so a replay simulates the same frames as the recording
+    {
+        // TODO: config
+        const char* replay_path = getenv("WARPUNK_REPLAY_INPUT");
+        const char* record_path = getenv("WARPUNK_RECORD_INPUT");
+        if (replay_path != nullptr)
+        {
+            if (!input_player_open(&state.input_player, replay_path))
+            {
+                WERROR("Failed to open the input replay.");
+                return false;
+            }
+            state.is_replaying_input = true;
+            state.fixed_delta_seconds = state.input_player.fixed_delta_seconds;
+            WINFO("Replaying %llu frames of input from %s.", (unsigned long long)state.input_player.frame_count, replay_path);
+        }
+        else if (record_path != nullptr)
+        {
+            if (!input_recorder_open(&state.input_recorder, record_path, state.target_frame_seconds))
+            {
+                WERROR("Failed to start the input recording.");
+                return false;
+            }
+            state.is_recording_input = true;
+            state.fixed_delta_seconds = state.target_frame_seconds;
+            WINFO("Recording input to %s.", record_path);
+        }
     }
 
     // Renderer system
     {
         // TODO: Later from the config
         renderer_config config = {};
-        config.type = RENDERER_TYPE_VULKAN;
+        /** vulkan needs a window surface, the software renderer presents into the headless framebuffer sink */
+        config.type = platform_is_headless() ? RENDERER_TYPE_SOFTWARE : RENDERER_TYPE_VULKAN;
         config.application_name = "Magicians Misfits";
         config.width = 1920 / 2;
         config.aspect_ratio = 16.0 / 9.0;
+        config.target_frame_seconds = state.target_frame_seconds;
         config.flags = RENDERER_CONFIG_FLAG_VSYNC_ENABLED_BIT;
         if (!renderer_startup(config))
         {
@@ -62,41 +277,220 @@ b8 engine_create(struct application* app)
         }
     }
 
+    // Frame statistics
+    {
+        frame_stats_config config = {};
+        config.target_frame_seconds = state.target_frame_seconds;
+        config.report_interval_seconds = 5.0;
+        frame_stats_init(&state.frame_stats, config);
+    }
+
+    // Frame pacing
+    {
+        // TODO: FRAME_PACER_MODE_VSYNC once the renderer presents
+        frame_pacer_config config = {};
+        config.mode = FRAME_PACER_MODE_FIXED;
+        config.target_frame_seconds = state.target_frame_seconds;
+        frame_pacer_init(&state.frame_pacer, config);
+    }
+
     return true;
 }
 
+/** runs render_frame for one slot, on the render thread */
+static void engine_render_main(void* arg)
+{
+    engine_frame_slot* slot = *(engine_frame_slot **)arg;
+
+    WPROFILE_SCOPE("render");
+    u64 start_ticks = platform_get_ticks();
+    slot->is_rendered = state.app->render_frame(state.app, &slot->packet);
+    slot->present_ticks = platform_get_ticks();
+    slot->render_seconds = platform_ticks_to_seconds(slot->present_ticks - start_ticks);
+}
+
+/** sync point: waits until the render thread finished the frame in flight, if any */
+static void engine_finish_render()
+{
+    if (state.rendering_slot == nullptr)
+    {
+        return;
+    }
+
+    if (state.is_render_threaded)
+    {
+        WPROFILE_SCOPE("render wait");
+        platform_threadpool_sync(state.render_ticket, 0.0);
+    }
+    if (!state.rendering_slot->is_rendered)
+    {
+        WERROR("Application render failed, shutting down.");
+        state.is_running = false;
+    }
+    frame_stats_record(&state.frame_stats, FRAME_STATS_PHASE_RENDER, state.rendering_slot->render_seconds);
+    if (state.rendering_slot->input_ticks != 0)
+    {
+        u64 latency_ticks = state.rendering_slot->present_ticks - state.rendering_slot->input_ticks;
+        frame_stats_record_input_latency(&state.frame_stats, platform_ticks_to_seconds(latency_ticks));
+    }
+    state.rendering_slot = nullptr;
+}
+
+/** hands `slot` to the render thread, renders on the calling thread if no thread is available */
+static void engine_start_render(engine_frame_slot* slot)
+{
+    platform_threading_job job = {};
+    job.function = engine_render_main;
+    job.arg = &slot;
+    job.arg_size = sizeof(engine_frame_slot *);
+    state.rendering_slot = slot;
+    state.is_render_threaded = platform_threadpool_add(&job, 1, &state.render_ticket);
+    if (!state.is_render_threaded)
+    {
+        engine_render_main(&slot);
+    }
+}
+
 b8 engine_run(struct application* app)
 {
-    f64 target_frame_seconds = 1.0f / 60;
-    f64 frame_elapsed_time = 0;
+    state.app = app;
+
+    for (s32 slot_idx = 0; slot_idx < ENGINE_FRAME_SLOT_COUNT; ++slot_idx)
+    {
+        state.frame_slots[slot_idx] = {};
+    }
+    state.frame_index = 0;
 
+    runtime_clock_start(&state.clock);
     while (state.is_running)
     {
-        WINFO("Test");
+        WPROFILE_SCOPE("frame");
+
         platform_process_input();
 
+        u64 event_ticks = platform_get_oldest_event_ticks();
+        if (event_ticks != 0 && (state.pending_input_ticks == 0 || event_ticks < state.pending_input_ticks))
+        {
+            state.pending_input_ticks = event_ticks;
+        }
+
         if (!state.is_suspended)
         {
             runtime_clock_update(&state.clock);
             f64 current_time = state.clock.elapsed;
-            f64 delta = current_time - state.last_time; (void)delta;
-            f64 frame_start_time = platform_get_absolute_time(); (void)frame_start_time;
+            if (state.is_resuming)
+            {
+                /** the suspension is neither simulated nor a hitch */
+                state.last_time = 0.0;
+                state.pending_input_ticks = 0;
+                state.is_resuming = false;
+                frame_pacer_reset(&state.frame_pacer);
+            }
+            f64 delta = (state.last_time != 0.0) ? current_time - state.last_time : 0.0;
+            if (state.fixed_delta_seconds > 0.0)
+            {
+                delta = state.fixed_delta_seconds;
+            }
+
+            if (state.is_replaying_input && !input_player_play_frame(&state.input_player, state.frame_index))
+            {
+                WINFO("Input replay finished after %llu frames.", (unsigned long long)state.frame_index);
+                state.is_running = false;
+                continue;
+            }
+
+            platform_perf_counters start_counters;
+            b8 has_counters = platform_perf_counters_read(&start_counters);
+
+            /** the slot's previous frame was waited for one frame ago, the render thread holds the other one */
+            engine_frame_slot* slot = &state.frame_slots[state.frame_index % ENGINE_FRAME_SLOT_COUNT];
+            slot->packet.frame_index = state.frame_index;
+            slot->packet.delta_seconds = delta;
+            /** the frame arena keeps it until the end of the next frame, when the render thread is done with it */
+            slot->packet.data = nullptr;
+            if (app->frame_packet_size > 0)
+            {
+                slot->packet.data = memory_system_frame_alloc(app->frame_packet_size);
+                if (slot->packet.data == nullptr)
+                {
+                    WERROR("Failed to allocate the frame packet, shutting down.");
+                    state.is_running = false;
+                    continue;
+                }
+            }
+            slot->input_ticks = state.pending_input_ticks;
+            state.pending_input_ticks = 0;
 
-            // TODO: frame
+            u64 update_start_ticks = platform_get_ticks();
+            {
+                WPROFILE_SCOPE("update");
+                if (!app->update(app) || !app->prepare_frame(app, &slot->packet))
+                {
+                    WERROR("Application update failed, shutting down.");
+                    state.is_running = false;
+                }
+            }
+            frame_stats_record(&state.frame_stats, FRAME_STATS_PHASE_UPDATE, platform_ticks_to_seconds(platform_get_ticks() - update_start_ticks));
 
-            f64 frame_end_time = platform_get_absolute_time();
-            f64 frame_elapsed_time = frame_end_time - frame_start_time;
-            f64 remaining_seconds = target_frame_seconds - frame_elapsed_time;
+            /** counts the main thread only, jobs on the thread pool show up in the profiler zones */
+            platform_perf_counters end_counters;
+            if (has_counters && platform_perf_counters_read(&end_counters))
+            {
+                for (s32 counter = 0; counter < PLATFORM_PERF_COUNTER_COUNT; ++counter)
+                {
+                    end_counters.values[counter] -= start_counters.values[counter];
+                }
+                frame_stats_record_counters(&state.frame_stats, &end_counters);
+            }
 
+            engine_finish_render();
+            if (state.is_running)
+            {
+                engine_start_render(slot);
+                state.frame_index++;
+            }
+
+            /** frame to frame, so the time spent outside the frame (input, pacing) shows up as well */
+            if (state.last_time != 0.0)
+            {
+                frame_stats_record(&state.frame_stats, FRAME_STATS_PHASE_FRAME, current_time - state.last_time);
+                frame_stats_end_frame(&state.frame_stats);
+            }
             state.last_time = current_time;
-            WINFO("last time: %e", state.last_time);
+
+            memory_system_frame_reset();
+
+            {
+                WPROFILE_SCOPE("pacing");
+                frame_pacer_wait(&state.frame_pacer);
+            }
         }
         else
         {
-            WDEBUG("suspended...");
+            /** nothing to draw, wake up for window events (input, expose, map, focus) or the timeout */
+            WPROFILE_SCOPE("idle");
+            platform_wait_for_events(ENGINE_IDLE_WAKE_SECONDS);
         }
     }
 
+    engine_finish_render();
+
+    if (state.is_recording_input)
+    {
+        input_recorder_close(&state.input_recorder, state.frame_index);
+    }
+    if (state.is_replaying_input)
+    {
+        input_player_close(&state.input_player);
+    }
+
+#if PROFILER_ENABLED == 1
+    profiler_export_chrome_trace("warpunk_trace.json");
+    profiler_shutdown();
+#endif
+
     platform_shutdown();
+    memory_system_shutdown();
+    logger_shutdown();
     return true;
 }